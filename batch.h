@@ -0,0 +1,252 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <istream>
+#include <ostream>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+
+#include "cubeState.h"
+#include "cubieCube.h"
+#include "twoPhase.h"
+#include "optimal.h"
+#include "threadPool.h"
+#include "solutionCache.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+//-------------------------------resolucion por lotes-----------------------------------
+// Lee mezclas de un flujo (una por linea: giros "R U F'" o 54 stickers en el orden de
+// Kociemba; las lineas vacias y las que empiezan por # se ignoran), las resuelve como
+// tareas de fondo del planificador y escribe una linea por mezcla en el orden de entrada.
+//
+// Los resultados que llegan antes de tiempo esperan en un buffer de reordenacion de
+// `window` huecos; cuando esta lleno, la lectura se para hasta que sale el mas antiguo.
+// Cada hilo del planificador tiene su solver; las tablas son las compartidas de
+// TwoPhaseTables / OptimalTables.
+// Con una SolutionCache se consulta antes de buscar y se guarda lo que se resuelve.
+
+// Pico de memoria residente del proceso en KB (0 si no se puede saber)
+inline long peakRssKb()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;   // en bytes
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+// Interpreta una linea como stickers o como giros
+inline bool parseScramble(const std::string& line, CubieCube& cube)
+{
+    if (line.size() == 54 && line.find(' ') == std::string::npos) return cube.fromFacelets(line);
+    std::vector<Turn> turns;
+    if (!parseMoves(line, turns)) return false;
+    CubeState state;
+    for (const Turn& t : turns) state.turn(t);
+    return cube.fromState(state);
+}
+
+class BatchSolver
+{
+public:
+    struct Options
+    {
+        bool optimal = false;
+        TableEncoding encoding = TableEncoding::Byte;
+        TaskScheduler* scheduler = nullptr;   // nullptr: el comun (TaskScheduler::instance())
+        size_t window = 1024;
+        SolutionCache* cache = nullptr;   // opcional; no es de BatchSolver
+    };
+
+    struct Stats
+    {
+        size_t solved = 0;
+        size_t failed = 0;
+        double seconds = 0.0;         // desde que las tablas estan listas
+        double tableSeconds = 0.0;    // mapear (o generar) las tablas
+        double p50Ms = 0.0;      // latencia de cada mezcla: de que un hilo la coge a que la resuelve
+        double p99Ms = 0.0;
+        double meanLength = 0.0;
+        long peakRssKb = 0;
+    };
+
+    explicit BatchSolver(const Options& options) : m_options(options)
+    {
+        if (!m_options.scheduler) m_options.scheduler = &TaskScheduler::instance();
+        if (m_options.window < (size_t)m_options.scheduler->size()) m_options.window = (size_t)m_options.scheduler->size();
+    }
+
+    Stats run(std::istream& in, std::ostream& out)
+    {
+        // Tablas antes de lanzar tareas (se generan o mapean una sola vez); no cuentan en
+        // el tiempo de resolucion
+        auto tables0 = std::chrono::steady_clock::now();
+        if (m_options.optimal) OptimalTables::get(m_options.encoding);
+        else TwoPhaseTables::get();
+        auto t0 = std::chrono::steady_clock::now();
+
+        m_slots.assign(m_options.window, Slot());
+        m_nextIn = m_nextOut = 0;
+        m_inputDone = false;
+        m_latencies.clear();
+        m_totalLength = 0;
+        m_failed = 0;
+        m_workers.clear();
+        m_workers.resize(m_options.scheduler->size());
+
+        TaskGroup group(*m_options.scheduler);
+        std::thread writer([this, &out] { writerLoop(out); });
+
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            const size_t first = line.find_first_not_of(" \t");
+            if (first == std::string::npos || line[first] == '#') continue;
+
+            size_t seq;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_space.wait(lock, [this] { return m_nextIn - m_nextOut < m_slots.size(); });
+                seq = m_nextIn++;
+            }
+            group.run(TaskPriority::Background, [this, seq, scramble = line.substr(first)] { solveLine(seq, scramble); });
+        }
+        group.wait();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_inputDone = true;
+        }
+        m_ready.notify_all();
+        writer.join();
+
+        Stats stats;
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        stats.tableSeconds = std::chrono::duration<double>(t0 - tables0).count();
+        stats.failed = m_failed;
+        stats.solved = m_latencies.size() - m_failed;
+        if (!m_latencies.empty()) {
+            std::sort(m_latencies.begin(), m_latencies.end());
+            stats.p50Ms = m_latencies[(m_latencies.size() - 1) / 2];
+            stats.p99Ms = m_latencies[(m_latencies.size() - 1) * 99 / 100];
+        }
+        if (stats.solved > 0) stats.meanLength = (double)m_totalLength / stats.solved;
+        stats.peakRssKb = peakRssKb();
+        return stats;
+    }
+
+private:
+    // Solvers de un hilo del planificador: solo los usa ese hilo, y las tareas del lote
+    // no esperan a otras, asi que nunca hay dos a la vez con los mismos
+    struct WorkerSolvers
+    {
+        std::unique_ptr<TwoPhaseSolver> twoPhase;
+        std::unique_ptr<OptimalSolver> optimal;
+    };
+
+    struct Slot
+    {
+        bool ready = false;
+        std::string output;
+    };
+
+    Options m_options;
+    std::mutex m_mutex;
+    std::condition_variable m_space, m_ready;
+    std::vector<WorkerSolvers> m_workers;
+    std::vector<Slot> m_slots;       // buffer de reordenacion: seq % window
+    size_t m_nextIn = 0, m_nextOut = 0;
+    bool m_inputDone = false;
+    std::vector<double> m_latencies;
+    size_t m_failed = 0;
+    long m_totalLength = 0;
+
+    void solveLine(size_t seq, const std::string& line)
+    {
+        WorkerSolvers& solvers = m_workers[m_options.scheduler->currentWorker()];
+        auto t0 = std::chrono::steady_clock::now();
+        std::string output;
+        int length = -1;
+        CubieCube cube;
+        if (!parseScramble(line, cube)) {
+            output = "ERROR: mezcla invalida";
+        } else {
+            std::vector<int> moves;
+            SolutionCache* cache = m_options.cache;
+            bool found = cache && cache->find(cube, m_options.optimal, moves);
+            if (!found) {
+                if (m_options.optimal) {
+                    if (!solvers.optimal) solvers.optimal.reset(new OptimalSolver(m_options.encoding));
+                    OptimalSolver::Result r = solvers.optimal->solve(cube);
+                    found = r.found;
+                    moves = r.moves;
+                } else {
+                    if (!solvers.twoPhase) solvers.twoPhase.reset(new TwoPhaseSolver());
+                    TwoPhaseSolver::Result r = solvers.twoPhase->solve(cube);
+                    found = r.found;
+                    moves = r.moves;
+                }
+                if (found && cache) cache->store(cube, moves, m_options.optimal);
+            }
+            if (found) {
+                length = (int)moves.size();
+                for (int m : moves) output += (output.empty() ? "" : " ") + moveToString(m);
+            } else {
+                output = "ERROR: sin solucion";
+            }
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Slot& slot = m_slots[seq % m_slots.size()];
+            slot.output = std::move(output);
+            slot.ready = true;
+            m_latencies.push_back(ms);
+            if (length < 0) m_failed++;
+            else m_totalLength += length;
+        }
+        m_ready.notify_one();
+    }
+
+    void writerLoop(std::ostream& out)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            m_ready.wait(lock, [this] {
+                return m_slots[m_nextOut % m_slots.size()].ready || (m_inputDone && m_nextOut == m_nextIn);
+            });
+            if (m_nextOut == m_nextIn && m_inputDone) break;
+
+            // Saca todos los consecutivos que ya estan; la escritura va fuera del cerrojo
+            std::vector<std::string> lines;
+            while (m_slots[m_nextOut % m_slots.size()].ready) {
+                Slot& slot = m_slots[m_nextOut % m_slots.size()];
+                lines.push_back(std::move(slot.output));
+                slot.ready = false;
+                m_nextOut++;
+            }
+            m_space.notify_all();
+            lock.unlock();
+            for (const std::string& l : lines) out << l << '\n';
+            out.flush();
+            lock.lock();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <cstring>
+
+//-------------------------------UBO de la camara---------------------------------------
+// Bloque std140 compartido por todos los programas que declaren:
+//
+//     layout (std140) uniform Camera {
+//         mat4 u_viewProj;
+//         mat4 u_view;
+//         mat4 u_projection;
+//         vec4 u_eye;
+//     };
+//
+// Se enlaza una sola vez al binding point CameraUBO::BINDING y solo se re-sube
+// cuando cambia la posicion de la camara o el viewport.
+
+class CameraUBO
+{
+public:
+    static const GLuint BINDING = 0;
+    static constexpr const char* BLOCK_NAME = "Camera";
+
+    CameraUBO() : m_ubo(0), m_width(0), m_height(0), m_dirty(true) {}
+
+    ~CameraUBO()
+    {
+        if (m_ubo) glDeleteBuffers(1, &m_ubo);
+    }
+
+    void create()
+    {
+        glGenBuffers(1, &m_ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, BINDING, m_ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    // La proyeccion solo se recalcula cuando cambia el tamaño del viewport
+    void setViewport(int width, int height)
+    {
+        if (width == m_width && height == m_height) return;
+        m_width = width;
+        m_height = height;
+        Mat4 proj = perspective(45.0f, (float)width / (float)height, 0.1f, 100.0f);
+        std::memcpy(m_block.projection, proj.m, sizeof(m_block.projection));
+        m_dirty = true;
+    }
+
+    void setLookAt(const Vec3& eye, const Vec3& center, const Vec3& up)
+    {
+        if (m_dirty == false && sameVec(eye, m_eye) && sameVec(center, m_center) && sameVec(up, m_up))
+            return;
+        m_eye = eye;
+        m_center = center;
+        m_up = up;
+        Mat4 view = lookAt(eye, center, up);
+        std::memcpy(m_block.view, view.m, sizeof(m_block.view));
+        m_block.eye[0] = eye.x; m_block.eye[1] = eye.y; m_block.eye[2] = eye.z; m_block.eye[3] = 1.0f;
+        m_dirty = true;
+    }
+
+    // Sube el bloque si algo cambió; devuelve true si hubo subida
+    bool update()
+    {
+        if (!m_dirty) return false;
+        multiply(m_block.viewProj, m_block.view, m_block.projection); // projection * view
+        glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &m_block);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        m_dirty = false;
+        return true;
+    }
+
+private:
+    // Layout std140: mat4 = 64 bytes, vec4 = 16 bytes, sin relleno extra
+    struct Block {
+        float viewProj[16];
+        float view[16];
+        float projection[16];
+        float eye[4];
+    };
+
+    GLuint m_ubo;
+    Block m_block;
+    int m_width, m_height;
+    Vec3 m_eye, m_center, m_up;
+    bool m_dirty;
+
+    static bool sameVec(const Vec3& a, const Vec3& b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+};
+
+#endif
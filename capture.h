@@ -0,0 +1,197 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+
+//------------------------------captura asincrona de frames------------------------------
+// glReadPixels sobre un PBO no bloquea: la copia la hace el driver en segundo plano.
+// Con un anillo de 3 PBOs el frame N se lee en PBO[N % 3] y se mapea el frame N-2,
+// que ya terminó hace dos frames, asi que glMapBuffer no espera a la GPU.
+// Los bytes mapeados se copian a un buffer del pool y un hilo escritor los vuelca:
+//   PPM  -> DIR/frame_0000.ppm, DIR/frame_0001.ppm, ...
+//   RAW  -> RGBA de arriba hacia abajo, todos los frames seguidos en un archivo
+//           ("-" = stdout), p. ej. ffmpeg -f rawvideo -pix_fmt rgba -s WxH -i -
+
+class FrameCapture
+{
+public:
+    enum class Format { PPM, RAW };
+
+    static const int RING_SIZE = 3;    // PBOs en vuelo
+    static const int POOL_SIZE = 4;    // frames esperando al escritor
+
+    FrameCapture() : m_width(0), m_height(0), m_format(Format::PPM), m_raw(nullptr),
+                     m_issued(0), m_drained(0), m_written(0), m_stop(false), m_failed(false) { m_pbo[0] = 0; }
+
+    ~FrameCapture() { finish(); }
+
+    // `target` = directorio (PPM) o archivo (RAW)
+    bool start(int width, int height, Format format, const std::string& target)
+    {
+        m_width = width;
+        m_height = height;
+        m_format = format;
+        m_target = target;
+
+        if (m_format == Format::RAW) {
+            m_raw = (target == "-") ? stdout : std::fopen(target.c_str(), "wb");
+            if (!m_raw) {
+                std::cout << "No se pudo abrir " << target << std::endl;
+                return false;
+            }
+        }
+
+        const GLsizeiptr bytes = frameBytes();
+        glGenBuffers(RING_SIZE, m_pbo);
+        for (int i = 0; i < RING_SIZE; ++i) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pbo[i]);
+            glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        for (int i = 0; i < POOL_SIZE; ++i)
+            m_free.push_back(std::vector<uint8_t>((size_t)bytes));
+
+        m_writer = std::thread(&FrameCapture::writerLoop, this);
+        return true;
+    }
+
+    // Encola la lectura del framebuffer de lectura actual (FBO o 0 = ventana)
+    void capture(GLuint framebuffer)
+    {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pbo[m_issued % RING_SIZE]);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        m_issued++;
+
+        if (m_issued > RING_SIZE - 1)
+            drain(m_issued - RING_SIZE + 1);
+    }
+
+    // Vacía los PBOs pendientes y espera a que el escritor termine
+    void finish()
+    {
+        if (!m_writer.joinable()) return;
+        while (m_drained < m_issued)
+            drain(m_issued);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cond.notify_all();
+        m_writer.join();
+
+        glDeleteBuffers(RING_SIZE, m_pbo);
+        if (m_raw && m_raw != stdout) std::fclose(m_raw);
+        else if (m_raw) std::fflush(m_raw);
+        m_raw = nullptr;
+    }
+
+    long framesWritten() const { return m_written; }
+    bool failed() const { return m_failed; }
+
+private:
+    GLuint m_pbo[RING_SIZE];
+    int m_width, m_height;
+    Format m_format;
+    std::string m_target;
+    FILE* m_raw;
+
+    long m_issued;           // lecturas encoladas en PBOs
+    long m_drained;          // frames ya copiados al pool
+    long m_written;          // frames escritos por el hilo (solo lo toca el escritor)
+
+    std::thread m_writer;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<std::vector<uint8_t>> m_free;                 // buffers libres
+    std::deque<std::pair<long, std::vector<uint8_t>>> m_ready; // (frame, pixeles) por escribir
+    bool m_stop;
+    bool m_failed;
+
+    GLsizeiptr frameBytes() const { return (GLsizeiptr)m_width * m_height * 4; }
+
+    // Mapea los PBOs de los frames [m_drained, upTo) y los pasa al escritor
+    void drain(long upTo)
+    {
+        for (; m_drained < upTo; ++m_drained) {
+            std::vector<uint8_t> buffer;
+            {
+                // Contrapresión: si el escritor va atrasado se espera a un buffer libre
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cond.wait(lock, [this] { return !m_free.empty(); });
+                buffer = std::move(m_free.front());
+                m_free.pop_front();
+            }
+
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pbo[m_drained % RING_SIZE]);
+            const void* src = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameBytes(), GL_MAP_READ_BIT);
+            if (src) {
+                std::memcpy(buffer.data(), src, buffer.size());
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            {
+                // Sin mapeo el buffer tiene pixeles de otro frame: se devuelve sin escribirlo
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (src) m_ready.emplace_back(m_drained, std::move(buffer));
+                else {
+                    m_failed = true;
+                    m_free.push_back(std::move(buffer));
+                }
+            }
+            m_cond.notify_all();
+        }
+    }
+
+    void writerLoop()
+    {
+        const size_t rowBytes = (size_t)m_width * 4;
+
+        for (;;) {
+            std::pair<long, std::vector<uint8_t>> frame;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cond.wait(lock, [this] { return m_stop || !m_ready.empty(); });
+                if (m_ready.empty()) return;
+                frame = std::move(m_ready.front());
+                m_ready.pop_front();
+            }
+
+            // OpenGL entrega las filas de abajo hacia arriba: se escriben invertidas
+            const uint8_t* pixels = frame.second.data();
+            bool ok = true;
+            if (m_format == Format::RAW) {
+                for (int y = m_height - 1; y >= 0 && ok; --y)
+                    ok = std::fwrite(pixels + y * rowBytes, 1, rowBytes, m_raw) == rowBytes;
+            }
+            else {
+                char name[32];
+                std::snprintf(name, sizeof(name), "/frame_%04ld.ppm", frame.first);
+                ok = writePPM(m_target + name, pixels, m_width, m_height);
+            }
+            if (ok) m_written++;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!ok) m_failed = true;
+                m_free.push_back(std::move(frame.second));
+            }
+            m_cond.notify_all();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,385 @@
+#ifndef COORDCUBE_H
+#define COORDCUBE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "cubieCube.h"
+#include "tableFile.h"
+
+//-------------------------------coordenadas enteras------------------------------------
+// Cada parte del CubieCube se resume en un entero pequeño; un giro de cara sobre una
+// coordenada es una sola lectura de tabla: TWIST_MOVE[twist][move].
+//
+//   TWIST         0..2186   orientacion de las esquinas (3^7)
+//   FLIP          0..2047   orientacion de las aristas (2^11)
+//   CORNER_PERM   0..40319  permutacion de las esquinas (8!)
+//   SLICE_SORTED  0..11879  posicion y orden de FR FL BL BR (12*11*10*9)
+//   U_EDGES       0..11879  idem para UR UF UL UB
+//   D_EDGES       0..11879  idem para DR DF DL DB
+//
+// SLICE_SORTED, U_EDGES y D_EDGES juntas determinan la permutacion completa de aristas.
+// SLICE_SORTED / 24 es la coordenada "slice" (0..494) de la fase 1, 0 = FR..BR en su capa.
+// Las tablas de orientacion se generan en tiempo de compilacion; las de permutacion se
+// mapean de COORD_MOVE_TABLE_FILE (se generan y se guardan la primera vez).
+
+const int NUM_TWIST = 2187;
+const int NUM_FLIP = 2048;
+const int NUM_CORNER_PERM = 40320;
+const int NUM_SLICE_SORTED = 11880;
+const int NUM_SLICE = 495;
+
+constexpr int binomial(int n, int k)
+{
+    if (k < 0 || k > n) return 0;
+    int r = 1;
+    for (int i = 1; i <= k; ++i) r = r * (n - k + i) / i;
+    return r;
+}
+
+// --- orientaciones ---
+
+constexpr int getTwist(const CubieCube& c)
+{
+    int t = 0;
+    for (int i = 0; i < NUM_CORNERS - 1; ++i) t = 3 * t + c.co[i];
+    return t;
+}
+
+constexpr void setTwist(CubieCube& c, int twist)
+{
+    int sum = 0;
+    for (int i = NUM_CORNERS - 2; i >= 0; --i) {
+        c.co[i] = (uint8_t)(twist % 3);
+        sum += c.co[i];
+        twist /= 3;
+    }
+    c.co[NUM_CORNERS - 1] = (uint8_t)((3 - sum % 3) % 3);
+}
+
+constexpr int getFlip(const CubieCube& c)
+{
+    int f = 0;
+    for (int i = 0; i < NUM_EDGES - 1; ++i) f = 2 * f + c.eo[i];
+    return f;
+}
+
+constexpr void setFlip(CubieCube& c, int flip)
+{
+    int sum = 0;
+    for (int i = NUM_EDGES - 2; i >= 0; --i) {
+        c.eo[i] = (uint8_t)(flip & 1);
+        sum += c.eo[i];
+        flip >>= 1;
+    }
+    c.eo[NUM_EDGES - 1] = (uint8_t)(sum & 1);
+}
+
+// --- permutaciones ---
+
+// Rango de Lehmer de p[0..n) (valores 0..n-1); identidad = 0
+constexpr int permRank(const uint8_t* p, int n)
+{
+    int r = 0;
+    for (int i = 0; i < n; ++i) {
+        int smaller = 0;
+        for (int j = i + 1; j < n; ++j)
+            if (p[j] < p[i]) smaller++;
+        r = r * (n - i) + smaller;
+    }
+    return r;
+}
+
+constexpr void permUnrank(uint8_t* p, int n, int r)
+{
+    int code[NUM_EDGES] = {};
+    for (int i = n - 1; i >= 0; --i) {
+        code[i] = r % (n - i);
+        r /= (n - i);
+    }
+    bool used[NUM_EDGES] = {};
+    for (int i = 0; i < n; ++i) {
+        int k = code[i];
+        for (int v = 0; v < n; ++v) {
+            if (used[v]) continue;
+            if (k-- == 0) { p[i] = (uint8_t)v; used[v] = true; break; }
+        }
+    }
+}
+
+constexpr int getCornerPerm(const CubieCube& c) { return permRank(c.cp, NUM_CORNERS); }
+constexpr void setCornerPerm(CubieCube& c, int perm) { permUnrank(c.cp, NUM_CORNERS, perm); }
+
+// Posicion y orden de las 4 aristas first..first+3: combinacion * 24 + orden.
+// La combinacion se cuenta desde BR hacia atras, asi que FR..BR en su capa = 0.
+constexpr int getEdges4(const CubieCube& c, int first)
+{
+    int comb = 0, k = 0;
+    uint8_t order[4] = {};
+    for (int q = 0; q < NUM_EDGES; ++q) {
+        const int e = c.ep[NUM_EDGES - 1 - q] - first;
+        if (e < 0 || e > 3) continue;
+        comb += binomial(q, k + 1);
+        order[3 - k] = (uint8_t)e;   // en orden creciente de posicion
+        k++;
+    }
+    return comb * 24 + permRank(order, 4);
+}
+
+constexpr void setEdges4(CubieCube& c, int first, int coord)
+{
+    uint8_t order[4] = {};
+    permUnrank(order, 4, coord % 24);
+    int comb = coord / 24;
+
+    bool chosen[NUM_EDGES] = {};
+    for (int k = 3; k >= 0; --k) {
+        int q = k;
+        while (binomial(q + 1, k + 1) <= comb) q++;
+        comb -= binomial(q, k + 1);
+        chosen[NUM_EDGES - 1 - q] = true;
+    }
+
+    int k = 0, other = 0;
+    for (int i = 0; i < NUM_EDGES; ++i) {
+        if (chosen[i]) {
+            c.ep[i] = (uint8_t)(first + order[k++]);
+        } else {
+            if (other == first) other += 4;
+            c.ep[i] = (uint8_t)other++;
+        }
+    }
+}
+
+constexpr int getSliceSorted(const CubieCube& c) { return getEdges4(c, FR); }
+constexpr int getUEdges(const CubieCube& c) { return getEdges4(c, UR); }
+constexpr int getDEdges(const CubieCube& c) { return getEdges4(c, DR); }
+
+//---------------------------------tablas de giros--------------------------------------
+
+template <int N>
+struct MoveTable
+{
+    uint16_t next[N][NUM_MOVES];   // next[coord][move]
+
+    constexpr const uint16_t* operator[](int coord) const { return next[coord]; }
+};
+
+// Con las columnas de cuarto de vuelta (f*3) rellenas, las potencias 2 y 3 salen
+// componiendo la propia tabla: 3 veces menos trabajo al generarla
+template <int N>
+constexpr void composePowers(MoveTable<N>& table)
+{
+    for (int i = 0; i < N; ++i)
+        for (int f = 0; f < 6; ++f) {
+            const int q2 = table.next[table.next[i][f * 3]][f * 3];
+            table.next[i][f * 3 + 1] = (uint16_t)q2;
+            table.next[i][f * 3 + 2] = table.next[q2][f * 3];
+        }
+}
+
+// Para cada valor: decodificar, aplicar el cuarto de vuelta de cada cara y codificar
+template <int N, typename Set, typename Get, typename Apply>
+constexpr MoveTable<N> makeMoveTable(Set set, Get get, Apply apply)
+{
+    MoveTable<N> table{};
+    for (int i = 0; i < N; ++i) {
+        CubieCube c = CubieCube::identity();
+        set(c, i);
+        for (int f = 0; f < 6; ++f) {
+            CubieCube m = c;
+            apply(m, BASIC_MOVES[f]);
+            table.next[i][f * 3] = (uint16_t)get(m);
+        }
+    }
+    composePowers(table);
+    return table;
+}
+
+constexpr void applyCorners(CubieCube& c, const CubieCube& m) { c.cornerMultiply(m); }
+constexpr void applyEdges(CubieCube& c, const CubieCube& m) { c.edgeMultiply(m); }
+constexpr void setUEdges(CubieCube& c, int v) { setEdges4(c, UR, v); }
+constexpr void setDEdges(CubieCube& c, int v) { setEdges4(c, DR, v); }
+constexpr void setSliceSorted(CubieCube& c, int v) { setEdges4(c, FR, v); }
+
+// Orientaciones: solo dependen de co/eo y del giro, asi que se generan en tiempo de
+// compilacion sin pasar por el CubieCube completo
+constexpr MoveTable<NUM_TWIST> makeTwistTable()
+{
+    MoveTable<NUM_TWIST> table{};
+    for (int i = 0; i < NUM_TWIST; ++i) {
+        CubieCube c{};
+        setTwist(c, i);
+        for (int f = 0; f < 6; ++f) {
+            const CubieCube& mv = BASIC_MOVES[f];
+            int t = 0;
+            for (int k = 0; k < NUM_CORNERS - 1; ++k) t = 3 * t + (c.co[mv.cp[k]] + mv.co[k]) % 3;
+            table.next[i][f * 3] = (uint16_t)t;
+        }
+    }
+    composePowers(table);
+    return table;
+}
+
+constexpr MoveTable<NUM_FLIP> makeFlipTable()
+{
+    MoveTable<NUM_FLIP> table{};
+    for (int i = 0; i < NUM_FLIP; ++i) {
+        CubieCube c{};
+        setFlip(c, i);
+        for (int f = 0; f < 6; ++f) {
+            const CubieCube& mv = BASIC_MOVES[f];
+            int flip = 0;
+            for (int k = 0; k < NUM_EDGES - 1; ++k) flip = 2 * flip + ((c.eo[mv.ep[k]] + mv.eo[k]) & 1);
+            table.next[i][f * 3] = (uint16_t)flip;
+        }
+    }
+    composePowers(table);
+    return table;
+}
+
+inline constexpr MoveTable<NUM_TWIST> TWIST_MOVE = makeTwistTable();
+inline constexpr MoveTable<NUM_FLIP> FLIP_MOVE = makeFlipTable();
+
+// Permutaciones: el mismo generador, pero evaluarlo en constexpr no cabe en los limites
+// del compilador. Se generan una vez (decenas de ms) y se guardan en un fichero de tablas;
+// los arranques siguientes solo lo mapean.
+// Tabla de giros dentro de un fichero mapeado (las secciones van alineadas a 4096)
+template <int N>
+bool attachMoveTable(const MappedTableFile& file, const char* name, const MoveTable<N>*& table)
+{
+    table = (const MoveTable<N>*)file.section(name, sizeof(MoveTable<N>));
+    return table != nullptr;
+}
+
+const char COORD_MOVE_TABLE_FILE[] = "cubi_moves.tbl";
+const uint32_t COORD_MOVE_TABLE_VERSION = 1;   // subir si cambia la definicion de alguna coordenada
+
+struct CoordMoveTables
+{
+    const MoveTable<NUM_CORNER_PERM>* cornerPerm;
+    const MoveTable<NUM_SLICE_SORTED>* sliceSorted;
+    const MoveTable<NUM_SLICE_SORTED>* uEdges;
+    const MoveTable<NUM_SLICE_SORTED>* dEdges;
+
+    TableOrigin origin;
+    std::string path;
+
+    static const CoordMoveTables& get()
+    {
+        static const CoordMoveTables tables;
+        return tables;
+    }
+
+    // Comprueba el checksum de cada seccion del fichero mapeado (lo lee entero)
+    bool verify() const { return !m_file.isOpen() || m_file.verify(); }
+
+private:
+    CoordMoveTables()
+    {
+        path = tablePath(COORD_MOVE_TABLE_FILE);
+        if (m_file.open(path, COORD_MOVE_TABLE_VERSION) && attach("cornerPerm", cornerPerm) &&
+            attach("sliceSorted", sliceSorted) && attach("uEdges", uEdges) && attach("dEdges", dEdges)) {
+            origin = TableOrigin::Mapped;
+            return;
+        }
+        m_file.close();
+
+        m_cornerPerm.reset(new MoveTable<NUM_CORNER_PERM>(
+            makeMoveTable<NUM_CORNER_PERM>(setCornerPerm, getCornerPerm, applyCorners)));
+        m_edges[0].reset(new MoveTable<NUM_SLICE_SORTED>(
+            makeMoveTable<NUM_SLICE_SORTED>(setSliceSorted, getSliceSorted, applyEdges)));
+        m_edges[1].reset(new MoveTable<NUM_SLICE_SORTED>(makeMoveTable<NUM_SLICE_SORTED>(setUEdges, getUEdges, applyEdges)));
+        m_edges[2].reset(new MoveTable<NUM_SLICE_SORTED>(makeMoveTable<NUM_SLICE_SORTED>(setDEdges, getDEdges, applyEdges)));
+        cornerPerm = m_cornerPerm.get();
+        sliceSorted = m_edges[0].get();
+        uEdges = m_edges[1].get();
+        dEdges = m_edges[2].get();
+
+        TableFileWriter writer;
+        writer.add("cornerPerm", cornerPerm, sizeof(*cornerPerm));
+        writer.add("sliceSorted", sliceSorted, sizeof(*sliceSorted));
+        writer.add("uEdges", uEdges, sizeof(*uEdges));
+        writer.add("dEdges", dEdges, sizeof(*dEdges));
+        origin = writer.write(path, COORD_MOVE_TABLE_VERSION) ? TableOrigin::Generated : TableOrigin::GeneratedNotSaved;
+    }
+
+    template <int N>
+    bool attach(const char* name, const MoveTable<N>*& table) const
+    {
+        return attachMoveTable(m_file, name, table);
+    }
+
+    MappedTableFile m_file;
+    std::unique_ptr<MoveTable<NUM_CORNER_PERM>> m_cornerPerm;    // solo si no se pudo mapear
+    std::unique_ptr<MoveTable<NUM_SLICE_SORTED>> m_edges[3];
+};
+
+inline const MoveTable<NUM_CORNER_PERM>& cornerPermMove() { return *CoordMoveTables::get().cornerPerm; }
+inline const MoveTable<NUM_SLICE_SORTED>& sliceSortedMove() { return *CoordMoveTables::get().sliceSorted; }
+inline const MoveTable<NUM_SLICE_SORTED>& uEdgesMove() { return *CoordMoveTables::get().uEdges; }
+inline const MoveTable<NUM_SLICE_SORTED>& dEdgesMove() { return *CoordMoveTables::get().dEdges; }
+
+//--------------------------------cubo en coordenadas-----------------------------------
+
+struct CoordCube
+{
+    uint16_t twist;
+    uint16_t flip;
+    uint16_t cornerPerm;
+    uint16_t sliceSorted;
+    uint16_t uEdges;
+    uint16_t dEdges;
+
+    static constexpr CoordCube fromCubie(const CubieCube& c)
+    {
+        return CoordCube{ (uint16_t)getTwist(c), (uint16_t)getFlip(c), (uint16_t)getCornerPerm(c),
+                          (uint16_t)getSliceSorted(c), (uint16_t)getUEdges(c), (uint16_t)getDEdges(c) };
+    }
+
+    // Reconstruye el cubo completo: las 3 coordenadas de aristas fijan las 12 posiciones
+    constexpr CubieCube toCubie() const
+    {
+        CubieCube c = CubieCube::identity();
+        setTwist(c, twist);
+        setFlip(c, flip);
+        setCornerPerm(c, cornerPerm);
+
+        CubieCube part = CubieCube::identity();
+        uint8_t ep[NUM_EDGES] = {};
+        const int FIRST[3] = { UR, DR, FR };
+        const uint16_t COORD[3] = { uEdges, dEdges, sliceSorted };
+        for (int g = 0; g < 3; ++g) {
+            setEdges4(part, FIRST[g], COORD[g]);
+            for (int i = 0; i < NUM_EDGES; ++i)
+                if (part.ep[i] >= FIRST[g] && part.ep[i] < FIRST[g] + 4) ep[i] = part.ep[i];
+        }
+        for (int i = 0; i < NUM_EDGES; ++i) c.ep[i] = ep[i];
+        return c;
+    }
+
+    void move(int m)
+    {
+        twist = TWIST_MOVE[twist][m];
+        flip = FLIP_MOVE[flip][m];
+        cornerPerm = cornerPermMove()[cornerPerm][m];
+        sliceSorted = sliceSortedMove()[sliceSorted][m];
+        uEdges = uEdgesMove()[uEdges][m];
+        dEdges = dEdgesMove()[dEdges][m];
+    }
+
+    constexpr bool operator==(const CoordCube& o) const
+    {
+        return twist == o.twist && flip == o.flip && cornerPerm == o.cornerPerm &&
+               sliceSorted == o.sliceSorted && uEdges == o.uEdges && dEdges == o.dEdges;
+    }
+    constexpr bool operator!=(const CoordCube& o) const { return !(*this == o); }
+};
+
+inline constexpr CoordCube SOLVED_COORDS = CoordCube::fromCubie(CubieCube::identity());
+
+static_assert(SOLVED_COORDS.twist == 0 && SOLVED_COORDS.flip == 0 && SOLVED_COORDS.cornerPerm == 0 &&
+              SOLVED_COORDS.sliceSorted == 0, "coordenadas del cubo resuelto");
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef CUBEMESH_H
+#define CUBEMESH_H
+
+#include <vector>
+#include <cstdint>
+
+#include "cubeState.h"
+
+//------------------------------malla compacta de stickers------------------------------
+// Solo se dibujan caras visibles: 1 instancia = 1 cara de un cubie.
+// La malla es un unico quad (4 vertices de 4 bytes + 6 indices de 16 bits); el vertex
+// shader lo coloca con la posicion del cubie y la base de la cara de cada instancia.
+//   uv -> GL_UNSIGNED_BYTE normalizado: esquina del quad y coordenadas para el borde
+//
+// Orden de caras de la malla: [R, L, U, D, F, B] = eje*2 + (normal negativa)
+
+struct PackedVertex
+{
+    uint8_t uv[2];
+    uint8_t pad[2];
+};
+
+static_assert(sizeof(PackedVertex) == 4, "PackedVertex debe ocupar 4 bytes");
+
+// Atributos por instancia: (x, y, z) del cubie, cara de la malla y Color
+struct StickerInstance
+{
+    uint8_t slot[3];
+    uint8_t face;
+    uint8_t color;
+    uint8_t pad[3];
+};
+
+static_assert(sizeof(StickerInstance) == 8, "StickerInstance debe ocupar 8 bytes");
+
+struct CubeMesh
+{
+    std::vector<PackedVertex> vertices;
+    std::vector<uint16_t> indices;
+};
+
+// 54 stickers exteriores + 2 planos de corte de 18 caras durante el giro de una capa
+const int MAX_STICKER_INSTANCES = 54 + 2 * 18;
+
+// Quad unidad en el plano (a, b) de la cara; en el shader a x b = normal,
+// asi que (0,0) (1,0) (1,1) (0,1) es antihorario visto desde fuera
+inline CubeMesh buildStickerQuad()
+{
+    const uint8_t CORNER[4][2] = { {0, 0}, {255, 0}, {255, 255}, {0, 255} };
+    CubeMesh mesh;
+    for (int c = 0; c < 4; ++c)
+        mesh.vertices.push_back(PackedVertex{ { CORNER[c][0], CORNER[c][1] }, { 0, 0 } });
+    mesh.indices = { 0, 1, 2, 0, 2, 3 };
+    return mesh;
+}
+
+// Genera las instancias de las caras visibles. Si `turning` no es nulo, la capa esta
+// girando y tambien se emiten (en negro) las caras que quedan al aire en sus planos de corte.
+inline int buildStickerInstances(const CubeState& state, const Turn* turning, StickerInstance* out)
+{
+    const Face MESH_FACES[6] = { Face::RIGHT, Face::LEFT, Face::UP, Face::DOWN, Face::FRONT, Face::BACK };
+    int count = 0;
+
+    for (int z = 0; z < 3; ++z)
+        for (int y = 0; y < 3; ++y)
+            for (int x = 0; x < 3; ++x)
+                for (int f = 0; f < 6; ++f) {
+                    int i = CubeState::faceletIndex(MESH_FACES[f], x, y, z);
+                    if (i < 0) continue;
+                    out[count++] = StickerInstance{ { (uint8_t)x, (uint8_t)y, (uint8_t)z }, (uint8_t)f,
+                                                    (uint8_t)state.get(i), { 0, 0, 0 } };
+                }
+
+    if (turning) {
+        const int axis = (int)turning->axis, slice = turning->slice;
+        for (int neighbor = slice - 1; neighbor <= slice + 1; neighbor += 2) {
+            if (neighbor < 0 || neighbor > 2) continue;
+            // Cara de la capa que mira al vecino y cara del vecino que mira a la capa
+            const int facingNeighbor = axis * 2 + (neighbor < slice ? 1 : 0);
+            const int facingSlice    = axis * 2 + (neighbor < slice ? 0 : 1);
+            for (int a = 0; a < 3; ++a)
+                for (int b = 0; b < 3; ++b) {
+                    uint8_t p[3];
+                    p[(axis + 1) % 3] = (uint8_t)a;
+                    p[(axis + 2) % 3] = (uint8_t)b;
+
+                    p[axis] = (uint8_t)slice;
+                    out[count++] = StickerInstance{ { p[0], p[1], p[2] }, (uint8_t)facingNeighbor,
+                                                    (uint8_t)Color::BLACK, { 0, 0, 0 } };
+                    p[axis] = (uint8_t)neighbor;
+                    out[count++] = StickerInstance{ { p[0], p[1], p[2] }, (uint8_t)facingSlice,
+                                                    (uint8_t)Color::BLACK, { 0, 0, 0 } };
+                }
+        }
+    }
+    return count;
+}
+
+#endif
@@ -0,0 +1,246 @@
+#ifndef CUBESTATE_H
+#define CUBESTATE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sstream>
+
+#include "orientation.h"
+
+//-----------------------------estado compacto del cubo---------------------------------
+// Los 54 stickers visibles del cubo 3x3, 1 byte por sticker, sin memoria dinamica.
+// Todo el estado ocupa exactamente una linea de cache (64 bytes).
+
+enum class Color : uint8_t { WHITE, YELLOW, RED, ORANGE, GREEN, BLUE, BLACK };
+enum class Face : uint8_t { UP, DOWN, LEFT, RIGHT, FRONT, BACK };
+enum class Axis : uint8_t { X, Y, Z };
+
+// Giro de una capa: `quarters` cuartos de vuelta de +90° (mano derecha) alrededor de +axis.
+// quarters = 1 (+90°), 2 (media vuelta), 3 (-90°). slice = 0..2 a lo largo del eje.
+struct Turn
+{
+    Axis axis;
+    uint8_t slice;
+    uint8_t quarters;
+
+    Turn inverse() const { return Turn{ axis, slice, (uint8_t)((4 - quarters) & 3) }; }
+};
+
+//---------------------------tablas de ciclos por capa---------------------------------
+// Un giro de +90° de una capa permuta sus stickers en ciclos de 4:
+// capa exterior = 5 ciclos (8 de la cara + 12 del contorno), capa media = 3 ciclos.
+// Las tablas se generan en tiempo de compilacion a partir de la geometria.
+
+struct LayerCycles
+{
+    uint8_t count;
+    uint8_t cycles[5][4];   // el sticker en cycles[k][j] pasa a cycles[k][j+1]
+};
+
+class alignas(64) CubeState
+{
+public:
+    static const int NUM_FACELETS = 54;
+
+    CubeState() { reset(); }
+
+    // Indice del sticker en la cara `face` del cubie (x,y,z), o -1 si esa cara es interna.
+    // Cada cara guarda 9 stickers: face*9 + a + b*3, con (a,b) las coordenadas libres.
+    static constexpr int faceletIndex(Face face, int x, int y, int z)
+    {
+        const int base = (int)face * 9;
+        switch (face) {
+            case Face::UP:    return (y == 2) ? base + x + z * 3 : -1;
+            case Face::DOWN:  return (y == 0) ? base + x + z * 3 : -1;
+            case Face::LEFT:  return (x == 0) ? base + z + y * 3 : -1;
+            case Face::RIGHT: return (x == 2) ? base + z + y * 3 : -1;
+            case Face::FRONT: return (z == 2) ? base + x + y * 3 : -1;
+            case Face::BACK:  return (z == 0) ? base + x + y * 3 : -1;
+        }
+        return -1;
+    }
+
+    Color get(int i) const { return m_facelets[i]; }
+    void set(int i, Color color) { m_facelets[i] = color; }
+
+    Color get(Face face, int x, int y, int z) const
+    {
+        int i = faceletIndex(face, x, y, z);
+        return (i < 0) ? Color::BLACK : m_facelets[i];
+    }
+
+    // Cubo resuelto: UP blanco, DOWN amarillo, LEFT verde, RIGHT azul, FRONT rojo, BACK naranja
+    void reset()
+    {
+        const Color SOLVED[6] = { Color::WHITE, Color::YELLOW, Color::GREEN,
+                                  Color::BLUE, Color::RED, Color::ORANGE };
+        for (int i = 0; i < NUM_FACELETS; ++i)
+            m_facelets[i] = SOLVED[i / 9];
+    }
+
+    // Resuelto = cada cara de un solo color (sin importar la orientacion global)
+    bool isSolved() const
+    {
+        for (int f = 0; f < 6; ++f)
+            for (int i = 1; i < 9; ++i)
+                if (m_facelets[f * 9 + i] != m_facelets[f * 9]) return false;
+        return true;
+    }
+
+    // Motor de giros: permuta in-place los ciclos precalculados de la capa
+    inline void turn(const Turn& t);
+
+    bool operator==(const CubeState& o) const { return m_facelets == o.m_facelets; }
+    bool operator!=(const CubeState& o) const { return !(*this == o); }
+
+private:
+    std::array<Color, NUM_FACELETS> m_facelets;
+};
+
+static_assert(sizeof(CubeState) == 64, "CubeState debe ocupar una sola linea de cache");
+
+constexpr std::array<LayerCycles, 9> makeLayerCycles()
+{
+    std::array<LayerCycles, 9> tables{};
+
+    for (int axis = 0; axis < 3; ++axis) {
+        const int r = TURN_ROTATION[axis][1];
+        for (int slice = 0; slice < 3; ++slice) {
+            int dest[CubeState::NUM_FACELETS] = {};
+            bool inLayer[CubeState::NUM_FACELETS] = {};
+
+            for (int i = 0; i < CubeState::NUM_FACELETS; ++i) {
+                // Decodificar el sticker i -> (cara, x, y, z)
+                int f = i / 9, a = i % 3, b = (i % 9) / 3;
+                int p[3] = {};
+                switch ((Face)f) {
+                    case Face::UP:    p[0] = a; p[1] = 2; p[2] = b; break;
+                    case Face::DOWN:  p[0] = a; p[1] = 0; p[2] = b; break;
+                    case Face::LEFT:  p[0] = 0; p[1] = b; p[2] = a; break;
+                    case Face::RIGHT: p[0] = 2; p[1] = b; p[2] = a; break;
+                    case Face::FRONT: p[0] = a; p[1] = b; p[2] = 2; break;
+                    case Face::BACK:  p[0] = a; p[1] = b; p[2] = 0; break;
+                }
+                if (p[axis] != slice) continue;
+                inLayer[i] = true;
+
+                // El sticker sigue a su cubie: hueco y cara salen de las tablas del grupo
+                const int slot = ROTATION_SLOT[r][p[0] + p[1] * 3 + p[2] * 9];
+                dest[i] = CubeState::faceletIndex((Face)ROTATION_FACE[r][f], slot % 3, slot / 3 % 3, slot / 9);
+            }
+
+            // Extraer los ciclos de 4 (los centros de las caras exteriores quedan fijos)
+            LayerCycles& L = tables[axis * 3 + slice];
+            bool visited[CubeState::NUM_FACELETS] = {};
+            for (int i = 0; i < CubeState::NUM_FACELETS; ++i) {
+                if (!inLayer[i] || visited[i] || dest[i] == i) continue;
+                int j = i;
+                for (int k = 0; k < 4; ++k) {
+                    L.cycles[L.count][k] = (uint8_t)j;
+                    visited[j] = true;
+                    j = dest[j];
+                }
+                L.count++;
+            }
+        }
+    }
+    return tables;
+}
+
+inline constexpr std::array<LayerCycles, 9> LAYER_CYCLES = makeLayerCycles();
+
+inline void CubeState::turn(const Turn& t)
+{
+    const LayerCycles& L = LAYER_CYCLES[(int)t.axis * 3 + t.slice];
+    Color* s = m_facelets.data();
+
+    switch (t.quarters & 3) {
+        case 1:
+            for (int k = 0; k < L.count; ++k) {
+                const uint8_t* c = L.cycles[k];
+                Color tmp = s[c[3]];
+                s[c[3]] = s[c[2]]; s[c[2]] = s[c[1]]; s[c[1]] = s[c[0]]; s[c[0]] = tmp;
+            }
+            break;
+        case 2:
+            for (int k = 0; k < L.count; ++k) {
+                const uint8_t* c = L.cycles[k];
+                Color tmp = s[c[0]]; s[c[0]] = s[c[2]]; s[c[2]] = tmp;
+                tmp = s[c[1]]; s[c[1]] = s[c[3]]; s[c[3]] = tmp;
+            }
+            break;
+        case 3:
+            for (int k = 0; k < L.count; ++k) {
+                const uint8_t* c = L.cycles[k];
+                Color tmp = s[c[0]];
+                s[c[0]] = s[c[1]]; s[c[1]] = s[c[2]]; s[c[2]] = s[c[3]]; s[c[3]] = tmp;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+//---------------------------------notacion estandar------------------------------------
+// U D R L F B (capas exteriores) y M E S (capas medias), con sufijos ' (antihorario) y 2.
+// Cada letra = (eje, slice, cuartos de +90° del giro horario visto desde esa cara).
+
+struct MoveName
+{
+    char letter;
+    Axis axis;
+    uint8_t slice;
+    uint8_t clockwise;
+};
+
+const MoveName MOVE_NAMES[9] = {
+    { 'U', Axis::Y, 2, 3 }, { 'D', Axis::Y, 0, 1 }, { 'E', Axis::Y, 1, 1 },
+    { 'R', Axis::X, 2, 3 }, { 'L', Axis::X, 0, 1 }, { 'M', Axis::X, 1, 1 },
+    { 'F', Axis::Z, 2, 3 }, { 'B', Axis::Z, 0, 1 }, { 'S', Axis::Z, 1, 3 },
+};
+
+inline bool parseTurn(const std::string& token, Turn& out)
+{
+    if (token.empty() || token.size() > 2) return false;
+    for (const MoveName& m : MOVE_NAMES) {
+        if (m.letter != token[0]) continue;
+        uint8_t quarters = m.clockwise;
+        if (token.size() == 2) {
+            if (token[1] == '2') quarters = 2;
+            else if (token[1] == '\'') quarters = (uint8_t)(4 - m.clockwise);
+            else return false;
+        }
+        out = Turn{ m.axis, m.slice, quarters };
+        return true;
+    }
+    return false;
+}
+
+// Secuencia separada por espacios ("R U R' U2"); false si algun token no es valido
+inline bool parseMoves(const std::string& text, std::vector<Turn>& out)
+{
+    std::istringstream in(text);
+    std::string token;
+    Turn t;
+    while (in >> token) {
+        if (!parseTurn(token, t)) return false;
+        out.push_back(t);
+    }
+    return true;
+}
+
+inline std::string turnToString(const Turn& t)
+{
+    for (const MoveName& m : MOVE_NAMES) {
+        if (m.axis != t.axis || m.slice != t.slice) continue;
+        std::string s(1, m.letter);
+        if (t.quarters == 2) s += '2';
+        else if (t.quarters != m.clockwise) s += '\'';
+        return s;
+    }
+    return "?";
+}
+
+#endif
@@ -0,0 +1,303 @@
+#ifndef CUBIECUBE_H
+#define CUBIECUBE_H
+
+#include <array>
+#include <string>
+#include <cstdint>
+
+#include "cubeState.h"
+
+//-------------------------------modelo por piezas--------------------------------------
+// Modelo logico para busqueda (convenciones de Kociemba): 8 esquinas y 12 aristas,
+// cada posicion guarda que pieza tiene (cp/ep) y con que orientacion (co/eo).
+// Los centros no existen aqui: todo es relativo a los centros actuales del cubo, asi que
+// los giros de capas medias (M E S) se ven como un giro de caras + rotacion del cubo.
+
+enum Corner : uint8_t { URF, UFL, ULB, UBR, DFR, DLF, DBL, DRB };
+enum Edge : uint8_t { UR, UF, UL, UB, DR, DF, DL, DB, FR, FL, BL, BR };
+
+const int NUM_CORNERS = 8;
+const int NUM_EDGES = 12;
+
+// Caras en el orden de Kociemba; los stickers se numeran cara*9 + fila*3 + columna
+// (U visto desde arriba con B al fondo, D desde abajo con F al fondo, el resto de frente)
+enum KFace : uint8_t { K_U, K_R, K_F, K_D, K_L, K_B };
+
+// Stickers de cada esquina/arista empezando por el de U/D (o F/B en las aristas del medio)
+constexpr uint8_t CORNER_FACELET[NUM_CORNERS][3] = {
+    { 8, 9, 20 }, { 6, 18, 38 }, { 0, 36, 47 }, { 2, 45, 11 },
+    { 29, 26, 15 }, { 27, 44, 24 }, { 33, 53, 42 }, { 35, 17, 51 }
+};
+constexpr uint8_t EDGE_FACELET[NUM_EDGES][2] = {
+    { 5, 10 }, { 7, 19 }, { 3, 37 }, { 1, 46 }, { 32, 16 }, { 28, 25 },
+    { 30, 43 }, { 34, 52 }, { 23, 12 }, { 21, 41 }, { 50, 39 }, { 48, 14 }
+};
+
+// Sticker de Kociemba -> indice en CubeState (x izquierda->derecha, y abajo->arriba, z atras->frente)
+constexpr int kociembaToFacelet(int k)
+{
+    const int r = (k % 9) / 3, c = k % 3;
+    switch ((KFace)(k / 9)) {
+        case K_U: return CubeState::faceletIndex(Face::UP,    c, 2, r);
+        case K_R: return CubeState::faceletIndex(Face::RIGHT, 2, 2 - r, 2 - c);
+        case K_F: return CubeState::faceletIndex(Face::FRONT, c, 2 - r, 2);
+        case K_D: return CubeState::faceletIndex(Face::DOWN,  c, 0, 2 - r);
+        case K_L: return CubeState::faceletIndex(Face::LEFT,  0, 2 - r, c);
+        case K_B: return CubeState::faceletIndex(Face::BACK,  2 - c, 2 - r, 0);
+    }
+    return -1;
+}
+
+struct CubieCube
+{
+    uint8_t cp[NUM_CORNERS];
+    uint8_t co[NUM_CORNERS];   // 0..2, giro horario del sticker U/D
+    uint8_t ep[NUM_EDGES];
+    uint8_t eo[NUM_EDGES];     // 0..1
+
+    static constexpr CubieCube identity()
+    {
+        CubieCube c{};
+        for (int i = 0; i < NUM_CORNERS; ++i) c.cp[i] = (uint8_t)i;
+        for (int i = 0; i < NUM_EDGES; ++i) c.ep[i] = (uint8_t)i;
+        return c;
+    }
+
+    // this = this * b  (primero this, despues b)
+    constexpr void multiply(const CubieCube& b)
+    {
+        cornerMultiply(b);
+        edgeMultiply(b);
+    }
+
+    constexpr void cornerMultiply(const CubieCube& b)
+    {
+        uint8_t p[NUM_CORNERS] = {}, o[NUM_CORNERS] = {};
+        for (int i = 0; i < NUM_CORNERS; ++i) {
+            p[i] = cp[b.cp[i]];
+            o[i] = (uint8_t)((co[b.cp[i]] + b.co[i]) % 3);
+        }
+        for (int i = 0; i < NUM_CORNERS; ++i) { cp[i] = p[i]; co[i] = o[i]; }
+    }
+
+    constexpr void edgeMultiply(const CubieCube& b)
+    {
+        uint8_t p[NUM_EDGES] = {}, o[NUM_EDGES] = {};
+        for (int i = 0; i < NUM_EDGES; ++i) {
+            p[i] = ep[b.ep[i]];
+            o[i] = (uint8_t)((eo[b.ep[i]] + b.eo[i]) & 1);
+        }
+        for (int i = 0; i < NUM_EDGES; ++i) { ep[i] = p[i]; eo[i] = o[i]; }
+    }
+
+    // Como multiply, pero admite esquinas reflejadas (orientacion 3..5, las simetrias con
+    // espejo) en cualquiera de los dos cubos; el producto de dos reflejados vuelve a 0..2
+    constexpr void symMultiply(const CubieCube& b)
+    {
+        uint8_t p[NUM_CORNERS] = {}, o[NUM_CORNERS] = {};
+        for (int i = 0; i < NUM_CORNERS; ++i) {
+            const int oa = co[b.cp[i]], ob = b.co[i];
+            p[i] = cp[b.cp[i]];
+            if (oa < 3 && ob < 3) o[i] = (uint8_t)((oa + ob) % 3);
+            else if (oa < 3) o[i] = (uint8_t)(3 + (oa + ob) % 3);
+            else if (ob < 3) o[i] = (uint8_t)(3 + (oa - ob + 3) % 3);
+            else o[i] = (uint8_t)((oa - ob + 3) % 3);
+        }
+        for (int i = 0; i < NUM_CORNERS; ++i) { cp[i] = p[i]; co[i] = o[i]; }
+        edgeMultiply(b);
+    }
+
+    // c * c.inverse() = identidad (tambien para las simetrias reflejadas)
+    constexpr CubieCube inverse() const
+    {
+        CubieCube d{};
+        for (int i = 0; i < NUM_CORNERS; ++i) d.cp[cp[i]] = (uint8_t)i;
+        for (int i = 0; i < NUM_CORNERS; ++i) {
+            const int ori = co[d.cp[i]];
+            d.co[i] = (uint8_t)(ori >= 3 ? ori : (3 - ori) % 3);
+        }
+        for (int i = 0; i < NUM_EDGES; ++i) d.ep[ep[i]] = (uint8_t)i;
+        for (int i = 0; i < NUM_EDGES; ++i) d.eo[i] = eo[d.ep[i]];
+        return d;
+    }
+
+    constexpr bool operator==(const CubieCube& o) const
+    {
+        for (int i = 0; i < NUM_CORNERS; ++i)
+            if (cp[i] != o.cp[i] || co[i] != o.co[i]) return false;
+        for (int i = 0; i < NUM_EDGES; ++i)
+            if (ep[i] != o.ep[i] || eo[i] != o.eo[i]) return false;
+        return true;
+    }
+    constexpr bool operator!=(const CubieCube& o) const { return !(*this == o); }
+
+    // Paridad de una permutacion (numero de inversiones modulo 2)
+    static constexpr int parity(const uint8_t* p, int n)
+    {
+        int s = 0;
+        for (int i = 0; i < n; ++i)
+            for (int j = i + 1; j < n; ++j)
+                if (p[j] < p[i]) s++;
+        return s & 1;
+    }
+
+    // Estado alcanzable: cada pieza una vez, giro total 0 mod 3, volteo total par, paridades iguales
+    constexpr bool isValid() const
+    {
+        int cornerSeen = 0, edgeSeen = 0, twist = 0, flip = 0;
+        for (int i = 0; i < NUM_CORNERS; ++i) {
+            if (cp[i] >= NUM_CORNERS || co[i] > 2) return false;
+            cornerSeen |= 1 << cp[i];
+            twist += co[i];
+        }
+        for (int i = 0; i < NUM_EDGES; ++i) {
+            if (ep[i] >= NUM_EDGES || eo[i] > 1) return false;
+            edgeSeen |= 1 << ep[i];
+            flip += eo[i];
+        }
+        return cornerSeen == 0xFF && edgeSeen == 0xFFF && twist % 3 == 0 && flip % 2 == 0 &&
+               parity(cp, NUM_CORNERS) == parity(ep, NUM_EDGES);
+    }
+
+    // --- importar / exportar desde los stickers del visor ---
+
+    // Falla si los colores no forman un cubo valido (centros repetidos, piezas imposibles...)
+    bool fromState(const CubeState& state)
+    {
+        // Cara de Kociemba de cada color segun los centros actuales
+        int faceOfColor[7] = { -1, -1, -1, -1, -1, -1, -1 };
+        for (int f = 0; f < 6; ++f) {
+            Color center = state.get(kociembaToFacelet(f * 9 + 4));
+            if (faceOfColor[(int)center] >= 0 || center == Color::BLACK) return false;
+            faceOfColor[(int)center] = f;
+        }
+        int facelet[54] = {};
+        for (int k = 0; k < 54; ++k) {
+            facelet[k] = faceOfColor[(int)state.get(kociembaToFacelet(k))];
+            if (facelet[k] < 0) return false;
+        }
+        return fromFaces(facelet);
+    }
+
+    // Cadena de 54 stickers en el orden de Kociemba (U1..U9 R1..R9 F.. D.. L.. B..). Cada
+    // letra vale la cara cuyo centro la lleva, asi sirve "UUUU...BBB" o letras de colores.
+    bool fromFacelets(const std::string& text)
+    {
+        if (text.size() != 54) return false;
+        int facelet[54] = {};
+        for (int k = 0; k < 54; ++k) {
+            facelet[k] = -1;
+            for (int f = 0; f < 6; ++f)
+                if (text[k] == text[f * 9 + 4]) {
+                    if (facelet[k] >= 0) return false;   // dos centros iguales
+                    facelet[k] = f;
+                }
+            if (facelet[k] < 0) return false;
+        }
+        return fromFaces(facelet);
+    }
+
+    // facelet[k] = cara (KFace) del color del sticker k
+    bool fromFaces(const int facelet[54])
+    {
+        for (int i = 0; i < NUM_CORNERS; ++i) {
+            const uint8_t* fac = CORNER_FACELET[i];
+            int ori = 0;
+            while (ori < 3 && facelet[fac[ori]] != K_U && facelet[fac[ori]] != K_D) ori++;
+            if (ori == 3) return false;
+            const int col1 = facelet[fac[(ori + 1) % 3]], col2 = facelet[fac[(ori + 2) % 3]];
+            cp[i] = 0xFF;
+            for (int j = 0; j < NUM_CORNERS; ++j)
+                if (col1 == CORNER_FACELET[j][1] / 9 && col2 == CORNER_FACELET[j][2] / 9) {
+                    cp[i] = (uint8_t)j;
+                    co[i] = (uint8_t)ori;
+                }
+        }
+
+        for (int i = 0; i < NUM_EDGES; ++i) {
+            const int a = facelet[EDGE_FACELET[i][0]], b = facelet[EDGE_FACELET[i][1]];
+            ep[i] = 0xFF;
+            for (int j = 0; j < NUM_EDGES; ++j) {
+                const int ja = EDGE_FACELET[j][0] / 9, jb = EDGE_FACELET[j][1] / 9;
+                if (a == ja && b == jb) { ep[i] = (uint8_t)j; eo[i] = 0; }
+                if (a == jb && b == ja) { ep[i] = (uint8_t)j; eo[i] = 1; }
+            }
+        }
+        return isValid();
+    }
+
+    // Escribe las piezas en `state` conservando los colores de sus centros
+    void toState(CubeState& state) const
+    {
+        Color colorOfFace[6] = {};
+        for (int f = 0; f < 6; ++f)
+            colorOfFace[f] = state.get(kociembaToFacelet(f * 9 + 4));
+
+        for (int i = 0; i < NUM_CORNERS; ++i)
+            for (int n = 0; n < 3; ++n)
+                state.set(kociembaToFacelet(CORNER_FACELET[i][(n + co[i]) % 3]),
+                          colorOfFace[CORNER_FACELET[cp[i]][n] / 9]);
+        for (int i = 0; i < NUM_EDGES; ++i)
+            for (int n = 0; n < 2; ++n)
+                state.set(kociembaToFacelet(EDGE_FACELET[i][(n + eo[i]) % 2]),
+                          colorOfFace[EDGE_FACELET[ep[i]][n] / 9]);
+    }
+};
+
+//----------------------------------giros de cara---------------------------------------
+// 18 giros: cara*3 + (potencia-1) con caras U R F D L B y potencias 1 (horario), 2, 3 (')
+
+const int NUM_MOVES = 18;
+
+// Cuarto de vuelta horario de cada cara, como permutacion "la posicion i recibe la pieza p[i]"
+constexpr CubieCube BASIC_MOVES[6] = {
+    // U
+    { { UBR, URF, UFL, ULB, DFR, DLF, DBL, DRB }, { 0, 0, 0, 0, 0, 0, 0, 0 },
+      { UB, UR, UF, UL, DR, DF, DL, DB, FR, FL, BL, BR }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+    // R
+    { { DFR, UFL, ULB, URF, DRB, DLF, DBL, UBR }, { 2, 0, 0, 1, 1, 0, 0, 2 },
+      { FR, UF, UL, UB, BR, DF, DL, DB, DR, FL, BL, UR }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+    // F
+    { { UFL, DLF, ULB, UBR, URF, DFR, DBL, DRB }, { 1, 2, 0, 0, 2, 1, 0, 0 },
+      { UR, FL, UL, UB, DR, FR, DL, DB, UF, DF, BL, BR }, { 0, 1, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0 } },
+    // D
+    { { URF, UFL, ULB, UBR, DLF, DBL, DRB, DFR }, { 0, 0, 0, 0, 0, 0, 0, 0 },
+      { UR, UF, UL, UB, DF, DL, DB, DR, FR, FL, BL, BR }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+    // L
+    { { URF, ULB, DBL, UBR, DFR, UFL, DLF, DRB }, { 0, 1, 2, 0, 0, 2, 1, 0 },
+      { UR, UF, BL, UB, DR, DF, FL, DB, FR, UL, DL, BR }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+    // B
+    { { URF, UFL, UBR, DRB, DFR, DLF, ULB, DBL }, { 0, 0, 1, 2, 0, 0, 2, 1 },
+      { UR, UF, UL, BR, DR, DF, DL, BL, FR, FL, UB, DB }, { 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 1 } },
+};
+
+constexpr std::array<CubieCube, NUM_MOVES> makeMoveCubes()
+{
+    std::array<CubieCube, NUM_MOVES> moves{};
+    for (int f = 0; f < 6; ++f) {
+        CubieCube c = CubieCube::identity();
+        for (int p = 0; p < 3; ++p) {
+            c.multiply(BASIC_MOVES[f]);
+            moves[f * 3 + p] = c;
+        }
+    }
+    return moves;
+}
+
+inline constexpr std::array<CubieCube, NUM_MOVES> MOVE_CUBES = makeMoveCubes();
+
+// Giro de cara -> Turn del visor (misma capa exterior, mismo sentido)
+inline Turn moveToTurn(int move)
+{
+    const char LETTER[6] = { 'U', 'R', 'F', 'D', 'L', 'B' };
+    const char SUFFIX[3] = { 0, '2', '\'' };
+    std::string token(1, LETTER[move / 3]);
+    if (SUFFIX[move % 3]) token += SUFFIX[move % 3];
+    Turn t{};
+    parseTurn(token, t);
+    return t;
+}
+
+inline std::string moveToString(int move) { return turnToString(moveToTurn(move)); }
+
+#endif
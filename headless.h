@@ -0,0 +1,146 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+
+//--------------------------------render sin ventana-----------------------------------
+// Contexto OpenGL 3.3 core sin superficie (EGL surfaceless de Mesa): no necesita X11,
+// display ni GPU (llvmpipe). Todo se dibuja en un FBO.
+
+#ifdef CUBI_HAVE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+class HeadlessContext
+{
+public:
+    HeadlessContext() : m_display(EGL_NO_DISPLAY), m_context(EGL_NO_CONTEXT) {}
+
+    ~HeadlessContext()
+    {
+        if (m_display == EGL_NO_DISPLAY) return;
+        eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (m_context != EGL_NO_CONTEXT) eglDestroyContext(m_display, m_context);
+        eglTerminate(m_display);
+    }
+
+    bool create()
+    {
+        // Plataforma surfaceless si existe; si no, el display por defecto
+        auto getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay)
+            m_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (m_display == EGL_NO_DISPLAY)
+            m_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+        EGLint major, minor;
+        if (m_display == EGL_NO_DISPLAY || !eglInitialize(m_display, &major, &minor)) {
+            std::cout << "Failed to initialize EGL" << std::endl;
+            return false;
+        }
+        if (!eglBindAPI(EGL_OPENGL_API)) {
+            std::cout << "EGL: OpenGL API not available" << std::endl;
+            return false;
+        }
+
+        const EGLint contextAttribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 3,
+            EGL_CONTEXT_MINOR_VERSION, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        // Sin config ni superficie (EGL_KHR_no_config_context + EGL_KHR_surfaceless_context)
+        m_context = eglCreateContext(m_display, (EGLConfig)0, EGL_NO_CONTEXT, contextAttribs);
+        if (m_context == EGL_NO_CONTEXT ||
+            !eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context)) {
+            std::cout << "Failed to create surfaceless EGL context" << std::endl;
+            return false;
+        }
+
+        if (!gladLoadGL((GLADloadfunc)eglGetProcAddress)) {
+            std::cout << "Failed to initialize GLAD" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    EGLDisplay m_display;
+    EGLContext m_context;
+};
+#endif
+
+// FBO con color RGBA8 y profundidad de 24 bits (se lee con FrameCapture)
+class OffscreenTarget
+{
+public:
+    OffscreenTarget() : m_fbo(0), m_width(0), m_height(0) { m_rbo[0] = m_rbo[1] = 0; }
+
+    ~OffscreenTarget()
+    {
+        if (m_fbo) glDeleteFramebuffers(1, &m_fbo);
+        if (m_rbo[0]) glDeleteRenderbuffers(2, m_rbo);
+    }
+
+    bool create(int width, int height)
+    {
+        m_width = width;
+        m_height = height;
+        glGenFramebuffers(1, &m_fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+
+        glGenRenderbuffers(2, m_rbo);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_rbo[0]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_rbo[0]);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_rbo[1]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_rbo[1]);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void bind() const
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+        glViewport(0, 0, m_width, m_height);
+    }
+
+    GLuint id() const { return m_fbo; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+private:
+    GLuint m_fbo;
+    GLuint m_rbo[2];
+    int m_width, m_height;
+};
+
+// Escribe un PPM binario (P6) a partir de RGBA leido de OpenGL (filas de abajo hacia arriba)
+inline bool writePPM(const std::string& path, const uint8_t* rgba, int width, int height)
+{
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    std::fprintf(f, "P6\n%d %d\n255\n", width, height);
+    std::vector<uint8_t> row((size_t)width * 3);
+    for (int y = height - 1; y >= 0; --y) {
+        const uint8_t* src = rgba + (size_t)y * width * 4;
+        for (int x = 0; x < width; ++x) {
+            row[x * 3 + 0] = src[x * 4 + 0];
+            row[x * 3 + 1] = src[x * 4 + 1];
+            row[x * 3 + 2] = src[x * 4 + 2];
+        }
+        std::fwrite(row.data(), 1, row.size(), f);
+    }
+    return std::fclose(f) == 0;
+}
+
+#endif
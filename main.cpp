@@ -11,11 +11,17 @@
 #include <iostream>
 #include <string>
 #include <vector>
-#include <map>
 #include <array>
 #include <sstream>
 #include <fstream>
 #include <cstddef>      
+#include <cstdlib>
+#include <ctime>
+#include <cstring>
+#include <chrono>
+#include <mutex>
+#include <algorithm>
+#include <cstdio>
 
 // --- CONFIGURACIÓN ---
 const unsigned int SCR_WIDTH = 800;
@@ -29,17 +35,59 @@ const unsigned int SCR_HEIGHT = 600;
 // Vertex Shader
 const char* vertexShaderSource = R"glsl(
     #version 330 core
-    layout (location = 0) in vec3 aPos;
-    layout (location = 2) in int aFaceID;
+    layout (location = 1) in vec2 aFaceUV;     // esquina del quad = coordenadas locales de la cara (0..1)
 
-    flat out int v_FaceID; 
-    uniform mat4 model;
-    uniform mat4 view;
-    uniform mat4 projection;
+    // Atributos por instancia (1 instancia = 1 cara visible de un cubie)
+    layout (location = 3) in uvec4 iSticker;   // (x, y, z) del cubie + cara [R, L, U, D, F, B]
+    layout (location = 4) in uint iColor;      // Color del sticker
+
+    flat out uint v_ColorID; 
+    out vec2 v_FaceUV;
+
+    layout (std140) uniform Camera {
+        mat4 u_viewProj;     // projection * view, precalculado en la CPU
+        mat4 u_view;
+        mat4 u_projection;
+        vec4 u_eye;
+    };
+
+    uniform float u_spacing;
+
+    // Capa girando: (eje, capa), eje < 0 = ninguna; angulo en radianes alrededor de +eje
+    uniform ivec2 u_turnLayer;
+    uniform float u_turnAngle;
+
+    const float CUBIE_HALF_SIZE = 0.5;
+
+    // Base de cada cara, con AXIS_A x AXIS_B = NORMAL (quad antihorario visto desde fuera)
+    const vec3 FACE_NORMAL[6] = vec3[6](vec3( 1, 0, 0), vec3(-1, 0, 0), vec3(0, 1, 0),
+                                        vec3(0, -1, 0), vec3(0, 0, 1), vec3(0, 0, -1));
+    const vec3 FACE_AXIS_A[6] = vec3[6](vec3(0, 1, 0), vec3(0, 0, 1), vec3(0, 0, 1),
+                                        vec3(1, 0, 0), vec3(1, 0, 0), vec3(0, 1, 0));
+    const vec3 FACE_AXIS_B[6] = vec3[6](vec3(0, 0, 1), vec3(0, 1, 0), vec3(1, 0, 0),
+                                        vec3(0, 0, 1), vec3(0, 1, 0), vec3(1, 0, 0));
 
     void main() {
-        gl_Position = projection * view * model * vec4(aPos, 1.0);
-        v_FaceID = aFaceID;
+        uint f = iSticker.w;
+        vec3 local = FACE_NORMAL[f] + (2.0 * aFaceUV.x - 1.0) * FACE_AXIS_A[f]
+                                    + (2.0 * aFaceUV.y - 1.0) * FACE_AXIS_B[f];
+        vec3 center = (vec3(iSticker.xyz) - 1.0) * u_spacing;
+        vec3 p = center + local * CUBIE_HALF_SIZE;
+
+        // Solo las instancias de la capa: el estado no cambia hasta que acaba el giro
+        int axis = u_turnLayer.x;
+        if (axis >= 0 && int(iSticker[axis]) == u_turnLayer.y) {
+            int u = (axis + 1) % 3, v = (axis + 2) % 3;
+            float c = cos(u_turnAngle), s = sin(u_turnAngle);
+            vec3 r = p;
+            r[u] = c * p[u] - s * p[v];
+            r[v] = s * p[u] + c * p[v];
+            p = r;
+        }
+
+        gl_Position = u_viewProj * vec4(p, 1.0);
+        v_ColorID = iColor;
+        v_FaceUV = aFaceUV;
     }
 )glsl";
 
@@ -48,652 +96,176 @@ const char* fragmentShaderSource = R"glsl(
     #version 330 core
     out vec4 FragColor;
 
-    flat in int v_FaceID;
-    uniform vec3 u_faceColors[6]; // [R, L, U, D, F, B]
-	uniform float u_isBorder;
+    flat in uint v_ColorID;
+    in vec2 v_FaceUV;
+    uniform vec3 u_palette[7]; // indexado por Color
+
+    // Grosor del borde negro en unidades de la cara: no depende de la resolución
+    const float BORDER_WIDTH = 0.05;
 
     void main() {
-		if (u_isBorder > 0.5) {
-            // PASE 2: Estamos dibujando el borde, forzar a negro.
-            FragColor = vec4(0.0, 0.0, 0.0, 1.0);
-			
-        } else {
-            // PASE 1: Estamos dibujando el relleno, usar el color de la cara.
-            vec3 objectColor = u_faceColors[v_FaceID];
-            
-            // Si el fondo es negro (caras internas), píntalo de un gris oscuro.
-            if (objectColor == vec3(0.0, 0.0, 0.0)) {
-                 FragColor = vec4(0.05, 0.05, 0.05, 1.0); // Plástico base
-            } else {
-                 FragColor = vec4(objectColor, 1.0);
-			}
-		}
+        vec3 objectColor = u_palette[v_ColorID];
+
+        // Si el fondo es negro (caras internas), píntalo de un gris oscuro.
+        if (objectColor == vec3(0.0, 0.0, 0.0)) {
+            objectColor = vec3(0.05, 0.05, 0.05); // Plástico base
+        }
+
+        // Distancia al borde más cercano de la cara; fwidth suaviza el escalón (antialiasing)
+        vec2 d = min(v_FaceUV, 1.0 - v_FaceUV);
+        float edge = min(d.x, d.y);
+        float aa = fwidth(edge);
+        float border = 1.0 - smoothstep(BORDER_WIDTH - aa, BORDER_WIDTH + aa, edge);
+
+        FragColor = vec4(mix(objectColor, vec3(0.0), border), 1.0);
     }
 )glsl";
 
 
 // --- CLASE SHADER (SIMPLIFICADA) ---
 #include "shader.h"
+#include "camera.h"
 
 // --- ENUMS Y CLASES DEL CUBO ---
-
-enum class Color { WHITE, YELLOW, RED, ORANGE, GREEN, BLUE, BLACK };
-enum class Face { UP, DOWN, LEFT, RIGHT, FRONT, BACK };
-//using FaceColors = std::map<Face, Color>;
+#include "cubeState.h"
+#include "cubeMesh.h"
+#include "coordCube.h"
+#include "twoPhase.h"
+#include "optimal.h"
+#include "batch.h"
+#include "simulation.h"
+#include "headless.h"
+#include "capture.h"
 
 bool g_counterClockwise = false;
 
 
-// CLASE CUBIE: Almacena el estado de color de 1 pieza
-class Cubie {
-public:
-    Cubie() {
-        identity(this->modelMatrix);
-        m_faces[Face::UP]    = Color::BLACK;
-        m_faces[Face::DOWN]  = Color::BLACK;
-        m_faces[Face::LEFT]  = Color::BLACK;
-        m_faces[Face::RIGHT] = Color::BLACK;
-        m_faces[Face::FRONT] = Color::BLACK;
-        m_faces[Face::BACK]  = Color::BLACK;
-    }
-
-    float modelMatrix[16];
-
-    void setFaceColor(Face face, Color color) { m_faces[face] = color; }
-    Color getFaceColor(Face face) const { return m_faces.at(face); }
-
-    void init(int x, int y, int z, float spacing) {
-        float px = (x - 1.0f) * spacing;
-        float py = (y - 1.0f) * spacing;
-        float pz = (z - 1.0f) * spacing;
-        translate(this->modelMatrix, px, py, pz);
-    }
-	
-	// --- NUEVOS: rotaciones de colores internas (no tocan modelMatrix) ---
-    // Rotación de colores alrededor de Y: clockwise visto desde arriba
-    void rotateFacesYClockwise() {
-        Color oldLeft  = m_faces[Face::LEFT];
-        Color oldFront = m_faces[Face::FRONT];
-        Color oldRight = m_faces[Face::RIGHT];
-        Color oldBack  = m_faces[Face::BACK];
-
-        // mapping clockwise: LEFT <- FRONT, FRONT <- RIGHT, RIGHT <- BACK, BACK <- LEFT
-        m_faces[Face::RIGHT] = oldFront;
-        m_faces[Face::BACK]  = oldRight;
-        m_faces[Face::LEFT]  = oldBack;
-        m_faces[Face::FRONT] = oldLeft;
-        // UP and DOWN remain unchanged
-    }
-
-    void rotateFacesYCounterClockwise() {
-        // inverse of clockwise
-        Color oldLeft  = m_faces[Face::LEFT];
-        Color oldFront = m_faces[Face::FRONT];
-        Color oldRight = m_faces[Face::RIGHT];
-        Color oldBack  = m_faces[Face::BACK];
-
-        m_faces[Face::RIGHT] = oldBack;
-        m_faces[Face::BACK]  = oldLeft;
-        m_faces[Face::LEFT]  = oldFront;
-        m_faces[Face::FRONT] = oldRight;
-    }
-
-    void rotateFacesXClockwise() {
-		Color oldUp    = m_faces[Face::UP];
-		Color oldFront = m_faces[Face::FRONT];
-		Color oldDown  = m_faces[Face::DOWN];
-		Color oldBack  = m_faces[Face::BACK];
-
-		// UP → BACK → DOWN → FRONT → UP
-		m_faces[Face::BACK]  = oldUp;
-		m_faces[Face::DOWN]  = oldBack;
-		m_faces[Face::FRONT] = oldDown;
-		m_faces[Face::UP]    = oldFront;
-		// LEFT/RIGHT stay the same
-	}
-
-	
-	void rotateFacesXCounterClockwise() {
-		Color oldUp    = m_faces[Face::UP];
-		Color oldFront = m_faces[Face::FRONT];
-		Color oldDown  = m_faces[Face::DOWN];
-		Color oldBack  = m_faces[Face::BACK];
-
-		// UP → FRONT → DOWN → BACK → UP
-		m_faces[Face::FRONT] = oldUp;
-		m_faces[Face::DOWN]  = oldFront;
-		m_faces[Face::BACK]  = oldDown;
-		m_faces[Face::UP]    = oldBack;
-		// LEFT/RIGHT stay the same
-	}
-	
-	// ---------------- ROTACIÓN DE COLORES EN EJE Z ----------------
-	void rotateFacesZClockwise() {
-		Color oldUp    = m_faces[Face::UP];
-		Color oldRight = m_faces[Face::RIGHT];
-		Color oldDown  = m_faces[Face::DOWN];
-		Color oldLeft  = m_faces[Face::LEFT];
-		
-		m_faces[Face::UP] = oldLeft;
-		m_faces[Face::LEFT] = oldDown;
-		m_faces[Face::DOWN] = oldRight;
-		m_faces[Face::RIGHT] = oldUp;
-	}
-
-	void rotateFacesZCounterClockwise() {
-		Color oldUp    = m_faces[Face::UP];
-		Color oldRight = m_faces[Face::RIGHT];
-		Color oldDown  = m_faces[Face::DOWN];
-		Color oldLeft  = m_faces[Face::LEFT];
-		
-		m_faces[Face::UP] = oldRight;
-		m_faces[Face::RIGHT] = oldDown;
-		m_faces[Face::DOWN] = oldLeft;
-		m_faces[Face::LEFT] = oldUp;
-	}
-
-
-
-
-private:
-    std::map<Face, Color> m_faces;
-};
-
 //
 // CLASE RUBIKSCUBE
 //
 	
 class RubiksCube {
 public:
-    RubiksCube() {
-        for (int z = 0; z <= 2; z++) { 
-			for (int y = 0; y <= 2; y++) { 
-				for (int x = 0; x <= 2; x++) {
-					//if (x == 1 && y == 1 && z == 1) continue;
-
-					int i = getIndex(x, y, z);
-
-					m_cubies[i].init(x, y, z, m_spacing);
-
-					if (z == 2) m_cubies[i].setFaceColor(Face::FRONT, Color::RED);
-					if (z == 0) m_cubies[i].setFaceColor(Face::BACK, Color::ORANGE);
-					if (y == 2) m_cubies[i].setFaceColor(Face::UP, Color::WHITE);
-					if (y == 0) m_cubies[i].setFaceColor(Face::DOWN, Color::YELLOW);
-					if (x == 0) m_cubies[i].setFaceColor(Face::LEFT, Color::GREEN);
-					if (x == 2) m_cubies[i].setFaceColor(Face::RIGHT, Color::BLUE);
-				}
-			}
-		}
-    }
-
     ~RubiksCube() {
         glDeleteVertexArrays(1, &m_VAO);
         glDeleteBuffers(1, &m_VBO);
-		glDeleteBuffers(1, &m_EBO_relleno);
-		glDeleteBuffers(1, &m_EBO_bordes);
+        glDeleteBuffers(1, &m_instanceVBO);
+		glDeleteBuffers(1, &m_EBO);
     }
 
 	
-    void setupMesh() {
-        float s = 0.5f;
-		class Vertex { 
-		public:
-			Vec3 pos; 
-			GLint faceID; 
-		};
-        std::vector<Vertex> vertices = {
-            {{s, s, s}, 0}, {{s,-s, s}, 0}, {{s,-s,-s}, 0}, //Right Face
-            {{s,-s,-s}, 0}, {{s, s,-s}, 0}, {{s, s, s}, 0},
-            {{-s, s, s}, 1}, {{-s,-s,-s}, 1}, {{-s,-s, s}, 1}, //Left Face
-            {{-s,-s,-s}, 1}, {{-s, s, s}, 1}, {{-s, s,-s}, 1},
-            {{-s, s,-s}, 2}, {{s, s, s}, 2}, {{s, s,-s}, 2}, //Up Face
-            {{s, s, s}, 2}, {{-s, s,-s}, 2}, {{-s, s, s}, 2},
-            {{-s,-s,-s}, 3}, {{s,-s,-s}, 3}, {{s,-s, s}, 3}, //Down Face
-            {{s,-s, s}, 3}, {{-s,-s, s}, 3}, {{-s,-s,-s}, 3},
-            {{-s,-s, s}, 4}, {{s,-s, s}, 4}, {{s, s, s}, 4}, //Front Face 
-            {{s, s, s}, 4}, {{-s, s, s}, 4}, {{-s,-s, s}, 4},
-            {{-s,-s,-s}, 5}, {{-s, s,-s}, 5}, {{s, s,-s}, 5},// Back Face 
-            {{s, s,-s}, 5}, {{s,-s,-s}, 5}, {{-s,-s,-s}, 5}
-        };
-		
-		const unsigned int INDICES_RELLENO[36] = {
-			0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 
-			18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35
-		};
-		
-		const unsigned int BORDER_INDICES[24] = {
-
-		// Cara Frontal
-		24, 25,  // Inferior
-		25, 26,  // Derecha (v2)
-		26, 28,  // Superior (v4)
-		28, 24,  // Izquierda (v1)
-		// 2. Contorno de la Cara Trasera (Z-) - Usando los índices 30-35
-		30, 31, // Inferior (de (-s, -s, -s) a (s, -s, -s))
-		31, 32, // Derecha (de (s, -s, -s) a (s, s, -s))
-		32, 34, // Superior (de (s, s, -s) a (-s, s, -s))
-		34, 30, // Izquierda (de (-s, s, -s) a (-s, -s, -s))
-		
-		24, 30, // Inferior-Izquierda
-		25, 34, // Inferior-Derecha
-		26, 32, // Superior-Derecha
-		28, 31  // Superior-Izquierda
-
+    void setupMesh(const Shader& shader) {
+        m_uPalette = shader.uniform<GL_FLOAT_VEC3>("u_palette");
+        m_uSpacing = shader.uniform<GL_FLOAT>("u_spacing");
+        m_uTurnLayer = shader.uniform<GL_INT_VEC2>("u_turnLayer");
+        m_uTurnAngle = shader.uniform<GL_FLOAT>("u_turnAngle");
 
-		};
+        // Malla compartida: 1 quad de 4 vértices de 4 bytes + 6 índices de 16 bits
+        CubeMesh mesh = buildStickerQuad();
 
         glGenVertexArrays(1, &m_VAO);
         glGenBuffers(1, &m_VBO);
-		glGenBuffers(1, &m_EBO_relleno);
-		glGenBuffers(1, &m_EBO_bordes);
+		glGenBuffers(1, &m_EBO);
         glBindVertexArray(m_VAO);
         // VBO
 		glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
-		// EBO INDICES_RELLENO
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO_relleno);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(INDICES_RELLENO), INDICES_RELLENO, GL_STATIC_DRAW);
-		// EBO BORDER_INDICES
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO_bordes); 
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(BORDER_INDICES), BORDER_INDICES, GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(PackedVertex), mesh.vertices.data(), GL_STATIC_DRAW);
+		// EBO
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(uint16_t), mesh.indices.data(), GL_STATIC_DRAW);
+		m_indexCount = (GLsizei)mesh.indices.size();
 		
-        GLsizei stride = sizeof(Vertex);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, pos));
-        glEnableVertexAttribArray(0);
-        glVertexAttribIPointer(2, 1, GL_INT, stride, (void*)offsetof(Vertex, faceID));
-        glEnableVertexAttribArray(2);
-        glBindVertexArray(0);
-    }
+        GLsizei stride = sizeof(PackedVertex);
+        glVertexAttribPointer(1, 2, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)offsetof(PackedVertex, uv));
+        glEnableVertexAttribArray(1);
+
+        // Buffer de instancias: 1 por cara visible (+ planos de corte durante un giro)
+        glGenBuffers(1, &m_instanceVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(m_instances), nullptr, GL_DYNAMIC_DRAW);
+
+        GLsizei istride = sizeof(StickerInstance);
+        glVertexAttribIPointer(3, 4, GL_UNSIGNED_BYTE, istride, (void*)offsetof(StickerInstance, slot));
+        glEnableVertexAttribArray(3);
+        glVertexAttribDivisor(3, 1);
+        glVertexAttribIPointer(4, 1, GL_UNSIGNED_BYTE, istride, (void*)offsetof(StickerInstance, color));
+        glEnableVertexAttribArray(4);
+        glVertexAttribDivisor(4, 1);
 
-    void draw(Shader& shader) {
-        //shader.use();
-
-        glBindVertexArray(m_VAO);
-        Vec3 faceColors[6];
-
-        for (int i = 0; i < 27; i++){
-            Cubie& cubie = m_cubies[i];
-			// Enviamos la matriz model de cada cubie
-            shader.setMat4("model", cubie.modelMatrix);
-			// Enviamos los colores del cubie al shader
-            faceColors[0] = getVec3FromColor(cubie.getFaceColor(Face::RIGHT));
-            faceColors[1] = getVec3FromColor(cubie.getFaceColor(Face::LEFT));
-            faceColors[2] = getVec3FromColor(cubie.getFaceColor(Face::UP));
-            faceColors[3] = getVec3FromColor(cubie.getFaceColor(Face::DOWN));
-            faceColors[4] = getVec3FromColor(cubie.getFaceColor(Face::FRONT));
-            faceColors[5] = getVec3FromColor(cubie.getFaceColor(Face::BACK));
-			shader.setVec3Array("u_faceColors", 6, faceColors);
-			
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO_relleno); 
-			shader.setFloat("u_isBorder", 0.0f);
-			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-			 
-			glLineWidth(10.0f);
-			shader.setFloat("u_isBorder", 1.0f);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO_bordes); 
-			glDrawElements(GL_LINES, 24, GL_UNSIGNED_INT, 0);
-            //glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-        }
         glBindVertexArray(0);
+        m_instancesDirty = true;
     }
 
-	// Rotar la capa UP (y == 2) 90° clockwise visto desde arriba
-	void rotateUpLayerClockwise() {
-		// Guardamos la capa en una matriz 3x3 (índices por x,z)
-		std::array<Cubie, 9> layerOld;
-		for (int z = 0; z < 3; ++z) {
-			for (int x = 0; x < 3; ++x) {
-				int idx = getIndex(x, 2, z);
-				layerOld[x + z*3] = m_cubies[idx]; // copia
-			}
-		}
-
-		// Creamos la nueva disposición: mapping clockwise visto desde arriba:
-		// newX = z; newZ = 2 - x
-		std::array<Cubie, 9> layerNew;
-		for (int z = 0; z < 3; ++z) {
-			for (int x = 0; x < 3; ++x) {
-				int newX, newZ;
-
-				if (g_counterClockwise) {
-					// Sentido antihorario (CounterClockwise)
-					newX = 2 - z;
-					newZ = x;
-				} else {
-					// Sentido horario (Clockwise)
-					newX = z;
-					newZ = 2 - x;
-				}
-
-				layerNew[newX + newZ*3] = layerOld[x + z*3];
-			}
-		}
-
-		// Colocamos las piezas en m_cubies con las nuevas posiciones y actualizamos modelMatrix e faces
-		for (int newZ = 0; newZ < 3; ++newZ) {
-			for (int newX = 0; newX < 3; ++newX) {
-				int destIdx = getIndex(newX, 2, newZ);
-				// Re-init la posición física en mundo (centros en x,y,z)
-				layerNew[newX + newZ*3].init(newX, 2, newZ, m_spacing);
-				// Rotamos la asignación de colores internamente (porque la pieza gira)
-				if (g_counterClockwise)
-					layerNew[newX + newZ*3].rotateFacesYCounterClockwise();
-				else
-					layerNew[newX + newZ*3].rotateFacesYClockwise();
-
-				// Copiamos de vuelta
-				m_cubies[destIdx] = layerNew[newX + newZ*3];
-			} 
-		}
-	}
-	
-	void rotateMiddleLayerClockwise() {
-		// y == 1
-		std::array<Cubie, 9> layerOld;
-		for (int z = 0; z < 3; ++z) {
-			for (int x = 0; x < 3; ++x) {
-				int idx = getIndex(x, 1, z);
-				layerOld[x + z*3] = m_cubies[idx];
-			}
-		}
-
-		// (x,z) -> (z, 2 - x)
-		std::array<Cubie, 9> layerNew;
-		for (int z = 0; z < 3; ++z) {
-			for (int x = 0; x < 3; ++x) {
-				int newX, newZ;
-
-				if (g_counterClockwise) {
-					// Sentido antihorario (CounterClockwise)
-					newX = 2 - z;
-					newZ = x;
-				} else {
-					// Sentido horario (Clockwise)
-					newX = z;
-					newZ = 2 - x;
-				}
+    // 1 solo glDrawElementsInstanced para todas las caras visibles
+    void draw(Shader& shader) {
+        if (m_instancesDirty) updateInstances();
 
-				layerNew[newX + newZ*3] = layerOld[x + z*3];
-			}
-		}
-
-		// Aplicar nueva disposición
-		for (int newZ = 0; newZ < 3; ++newZ) {
-			for (int newX = 0; newX < 3; ++newX) {
-				int destIdx = getIndex(newX, 1, newZ);
-				layerNew[newX + newZ*3].init(newX, 1, newZ, m_spacing);
-				if (g_counterClockwise)
-					layerNew[newX + newZ*3].rotateFacesYCounterClockwise();
-				else
-					layerNew[newX + newZ*3].rotateFacesYClockwise();
-
-				m_cubies[destIdx] = layerNew[newX + newZ*3];
-			}
-		}
-	}
+        Vec3 palette[7];
+        for (int c = 0; c < 7; c++) palette[c] = getVec3FromColor((Color)c);
+        shader.setVec3Array(m_uPalette, 7, palette);
+        shader.setFloat(m_uSpacing, m_spacing);
+        shader.setIVec2(m_uTurnLayer, m_turning ? (int)m_turn.axis : -1, m_turn.slice);
+        shader.setFloat(m_uTurnAngle, m_turnAngle);
 
+        glBindVertexArray(m_VAO);
 
-	// ---------------- ROTACIÓN CAPA INFERIOR (DOWN) ----------------
-	void rotateDownLayerClockwise() {
-		// y == 0
-		std::array<Cubie, 9> layerOld;
-		for (int z = 0; z < 3; ++z) {
-			for (int x = 0; x < 3; ++x) {
-				int idx = getIndex(x, 0, z);
-				layerOld[x + z*3] = m_cubies[idx];
-			}
-		}
-
-		// (x,z) -> (z, 2 - x)
-		std::array<Cubie, 9> layerNew;
-		for (int z = 0; z < 3; ++z) {
-			for (int x = 0; x < 3; ++x) {
-				int newX, newZ;
-
-				if (g_counterClockwise) {
-					// Sentido antihorario (CounterClockwise)
-					newX = 2 - z;
-					newZ = x;
-				} else {
-					// Sentido horario (Clockwise)
-					newX = z;
-					newZ = 2 - x;
-				}
+        // Relleno y bordes en un solo pase (el borde se calcula en el fragment shader)
+        glDrawElementsInstanced(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_SHORT, 0, m_instanceCount);
 
-				layerNew[newX + newZ*3] = layerOld[x + z*3];
-			}
-		}
-
-		for (int newZ = 0; newZ < 3; ++newZ) {
-			for (int newX = 0; newX < 3; ++newX) {
-				int destIdx = getIndex(newX, 0, newZ);
-				layerNew[newX + newZ*3].init(newX, 0, newZ, m_spacing);
-				if (g_counterClockwise)
-					layerNew[newX + newZ*3].rotateFacesYCounterClockwise();
-				else
-					layerNew[newX + newZ*3].rotateFacesYClockwise();
-
-				m_cubies[destIdx] = layerNew[newX + newZ*3];
-			}
-		}
-	}
-	
-	// ---------------- ROTACIÓN CAPA DERECHA (x == 2) ----------------
-	void rotateRightLayerClockwise() {
-		std::array<Cubie, 9> layerOld;
-		for (int z = 0; z < 3; ++z)
-			for (int y = 0; y < 3; ++y)
-				layerOld[y + z*3] = m_cubies[getIndex(2, y, z)];
-
-		// (y,z) -> (z, 2 - y)
-		std::array<Cubie, 9> layerNew;
-		for (int z = 0; z < 3; ++z)
-			for (int y = 0; y < 3; ++y) {
-				int newY, newZ;
-				if (g_counterClockwise) {
-					// visto desde la derecha (−X)
-					newY = 2 - z;
-					newZ = y;
-				} else {
-					// horario visto desde la derecha (−X)
-					newY = z;
-					newZ = 2 - y;
-				}
-				layerNew[newY + newZ*3] = layerOld[y + z*3];
-			}
-
-		for (int newZ = 0; newZ < 3; ++newZ)
-			for (int newY = 0; newY < 3; ++newY) {
-				int destIdx = getIndex(2, newY, newZ);
-				layerNew[newY + newZ*3].init(2, newY, newZ, m_spacing);
-				if (g_counterClockwise)
-					layerNew[newY + newZ*3].rotateFacesXCounterClockwise();
-				else
-					layerNew[newY + newZ*3].rotateFacesXClockwise();
-
-				m_cubies[destIdx] = layerNew[newY + newZ*3];
-			}
-	}
+        glBindVertexArray(0);
+    }
 
-	// ---------------- ROTACIÓN CAPA MEDIA VERTICAL (x == 1) ----------------
-	void rotateMiddleVerticalClockwise() {
-		std::array<Cubie, 9> layerOld;
-		for (int z = 0; z < 3; ++z)
-			for (int y = 0; y < 3; ++y)
-				layerOld[y + z*3] = m_cubies[getIndex(1, y, z)];
-
-		std::array<Cubie, 9> layerNew;
-		for (int z = 0; z < 3; ++z)
-			for (int y = 0; y < 3; ++y) {
-				int newY, newZ;
-				if (g_counterClockwise) {
-					newY = 2 - z;
-					newZ = y;
-				} else {
-					newY = z;
-					newZ = 2 - y;
-				}
-				layerNew[newY + newZ*3] = layerOld[y + z*3];
-			}
-
-		for (int newZ = 0; newZ < 3; ++newZ)
-			for (int newY = 0; newY < 3; ++newY) {
-				int destIdx = getIndex(1, newY, newZ);
-				layerNew[newY + newZ*3].init(1, newY, newZ, m_spacing);
-				if (g_counterClockwise)
-					layerNew[newY + newZ*3].rotateFacesXCounterClockwise();
-				else
-					layerNew[newY + newZ*3].rotateFacesXClockwise();
-
-				m_cubies[destIdx] = layerNew[newY + newZ*3];
-			}
+	// Motor de giros: cualquier capa (eje, slice), cuarto o media vuelta, en ambos sentidos
+	void turn(const Turn& t) {
+		m_state.turn(t);
+		m_instancesDirty = true;
 	}
 
-	// ---------------- ROTACIÓN CAPA IZQUIERDA (x == 0) ----------------
-	void rotateLeftLayerClockwise() {
-		std::array<Cubie, 9> layerOld;
-		for (int z = 0; z < 3; ++z)
-			for (int y = 0; y < 3; ++y)
-				layerOld[y + z*3] = m_cubies[getIndex(0, y, z)];
-
-		std::array<Cubie, 9> layerNew;
-		for (int z = 0; z < 3; ++z)
-			for (int y = 0; y < 3; ++y) {
-				int newY, newZ;
-				if (g_counterClockwise) {
-					newY = 2 - z;
-					newZ = y;
-				} else {
-					newY = z;
-					newZ = 2 - y;
-				}
-				layerNew[newY + newZ*3] = layerOld[y + z*3];
-			}
-
-		for (int newZ = 0; newZ < 3; ++newZ)
-			for (int newY = 0; newY < 3; ++newY) {
-				int destIdx = getIndex(0, newY, newZ);
-				layerNew[newY + newZ*3].init(0, newY, newZ, m_spacing);
-				if (g_counterClockwise)
-					layerNew[newY + newZ*3].rotateFacesXCounterClockwise();
-				else
-					layerNew[newY + newZ*3].rotateFacesXClockwise();
-
-				m_cubies[destIdx] = layerNew[newY + newZ*3];
-			}
-	}
-	
-	// ---------------- ROTACIÓN CAPA FRONTAL (z == 2) ----------------
-	void rotateFrontLayerClockwise() {
-		std::array<Cubie, 9> layerOld;
-		for (int y = 0; y < 3; ++y)
-			for (int x = 0; x < 3; ++x)
-				layerOld[x + y * 3] = m_cubies[getIndex(x, y, 2)];
-
-		std::array<Cubie, 9> layerNew;
-		for (int y = 0; y < 3; ++y)
-			for (int x = 0; x < 3; ++x) {
-				int newX, newY;
-				if (g_counterClockwise) {
-					newX = 2 - y;
-					newY = x;
-				} else {
-					newX = y;
-					newY = 2 - x;
-				}
-				layerNew[newX + newY * 3] = layerOld[x + y * 3];
-			}
-
-		for (int newY = 0; newY < 3; ++newY)
-			for (int newX = 0; newX < 3; ++newX) {
-				int destIdx = getIndex(newX, newY, 2);
-				layerNew[newX + newY * 3].init(newX, newY, 2, m_spacing);
-				if (g_counterClockwise)
-					layerNew[newX + newY * 3].rotateFacesZCounterClockwise();
-				else
-					layerNew[newX + newY * 3].rotateFacesZClockwise();
-
-				m_cubies[destIdx] = layerNew[newX + newY * 3];
-			}
+	const CubeState& state() const { return m_state; }
+
+	// Capa que se esta girando (nullptr = ninguna) y su angulo; la gira el vertex shader,
+	// aqui solo cambian las instancias cuando empieza o acaba (planos de corte)
+	void setTurn(const Turn* turn, float angle) {
+		const bool turning = turn != nullptr;
+		if (turning != m_turning || (turning && (turn->axis != m_turn.axis || turn->slice != m_turn.slice)))
+			m_instancesDirty = true;
+		m_turning = turning;
+		if (turning) m_turn = *turn;
+		m_turnAngle = turning ? angle : 0.0f;
 	}
 
-	// ---------------- ROTACIÓN CAPA MEDIA PROFUNDIDAD (z == 1) ----------------
-	void rotateMiddleDepthClockwise() {
-		std::array<Cubie, 9> layerOld;
-		for (int y = 0; y < 3; ++y)
-			for (int x = 0; x < 3; ++x)
-				layerOld[x + y * 3] = m_cubies[getIndex(x, y, 1)];
-
-		std::array<Cubie, 9> layerNew;
-		for (int y = 0; y < 3; ++y)
-			for (int x = 0; x < 3; ++x) {
-				int newX, newY;
-				if (g_counterClockwise) {
-					newX = 2 - y;
-					newY = x;
-				} else {
-					newX = y;
-					newY = 2 - x;
-				}
-				layerNew[newX + newY * 3] = layerOld[x + y * 3];
-			}
-
-		for (int newY = 0; newY < 3; ++newY)
-			for (int newX = 0; newX < 3; ++newX) {
-				int destIdx = getIndex(newX, newY, 1);
-				layerNew[newX + newY * 3].init(newX, newY, 1, m_spacing);
-				if (g_counterClockwise)
-					layerNew[newX + newY * 3].rotateFacesZCounterClockwise();
-				else
-					layerNew[newX + newY * 3].rotateFacesZClockwise();
-
-				m_cubies[destIdx] = layerNew[newX + newY * 3];
-			}
-	}
-	
-	// ---------------- ROTACIÓN CAPA TRASERA (z == 0) ----------------
-	void rotateBackLayerClockwise() {
-		std::array<Cubie, 9> layerOld;
-		for (int y = 0; y < 3; ++y)
-			for (int x = 0; x < 3; ++x)
-				layerOld[x + y * 3] = m_cubies[getIndex(x, y, 0)];
-
-		std::array<Cubie, 9> layerNew;
-		for (int y = 0; y < 3; ++y)
-			for (int x = 0; x < 3; ++x) {
-				int newX, newY;
-				if (g_counterClockwise) {
-					// Ojo: visto desde atrás, el sentido se invierte
-					newX = 2 - y;
-					newY = x;
-				} else {
-					newX = y;
-					newY = 2 - x;
-				}
-				layerNew[newX + newY * 3] = layerOld[x + y * 3];
-			}
-
-		for (int newY = 0; newY < 3; ++newY)
-			for (int newX = 0; newX < 3; ++newX) {
-				int destIdx = getIndex(newX, newY, 0);
-				layerNew[newX + newY * 3].init(newX, newY, 0, m_spacing);
-				if (g_counterClockwise)
-					layerNew[newX + newY * 3].rotateFacesZCounterClockwise();
-				else
-					layerNew[newX + newY * 3].rotateFacesZClockwise();
-
-				m_cubies[destIdx] = layerNew[newX + newY * 3];
-			}
+	// Sustituye los colores de golpe (p. ej. exportados desde un CubieCube)
+	void setState(const CubeState& state) {
+		m_state = state;
+		m_instancesDirty = true;
 	}
 	
 private:
-    std::array<Cubie, 27> m_cubies;
+    CubeState m_state;               // colores de los 54 stickers
+    std::array<StickerInstance, MAX_STICKER_INSTANCES> m_instances;
+    GLsizei m_instanceCount = 0;
+    bool m_instancesDirty = true;    // los colores cambiaron desde la última subida
+    bool m_turning = false;
+    Turn m_turn{};
+    float m_turnAngle = 0.0f;
     GLuint m_VAO, m_VBO;
-	GLuint m_EBO_relleno; // EBO para 36 índices (triángulos)
-	GLuint m_EBO_bordes;
+    GLuint m_instanceVBO;
+    Shader::Vec3Handle m_uPalette;
+    Shader::FloatHandle m_uSpacing;
+    Shader::IVec2Handle m_uTurnLayer;
+    Shader::FloatHandle m_uTurnAngle;
+	GLuint m_EBO;           // índices de 16 bits (triángulos)
+	GLsizei m_indexCount;
     const float m_spacing = 1.0f;
 
-    int getIndex(int x, int y, int z) const { return x + y * 3 + z * 9; }
+    // Re-genera y sube las instancias (solo tras un giro o al empezar/acabar uno animado)
+    void updateInstances() {
+        m_instanceCount = buildStickerInstances(m_state, m_turning ? &m_turn : nullptr, m_instances.data());
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, m_instanceCount * sizeof(StickerInstance), m_instances.data());
+        m_instancesDirty = false;
+    }
 
     Vec3 getVec3FromColor(Color color) {
         switch (color) {
@@ -710,79 +282,200 @@ private:
 };
 
 //-------------------variables globales-----------------------
-RubiksCube* g_rubiksCube = nullptr;
+RubiksCube* g_rubiksCube = nullptr;      // lo que se dibuja: la ultima instantanea de g_simulation
+CubeSimulation* g_simulation = nullptr;  // dueno del estado: los giros se le mandan a el
 bool keyProcessed[348] = {false};
 Vec3 g_cameraPos(0.0f, 0.0f, 5.0f);
+Shader::UploadStats g_uniformStats; // subidas de uniforms del último frame
+
+const int STRESS_SCRIPT_LENGTH = 10000;  // tecla T
+const float TURN_SECONDS = 0.2f;         // duracion de un giro animado sin cola detras
 
 enum class ActiveFace { FRONT = 1, BACK, LEFT, RIGHT, UP, DOWN };
 ActiveFace g_activeFace = ActiveFace::FRONT;
 
+// Sentido "clockwise" del visor por eje, en cuartos de vuelta de +90°:
+// en X y Z es -90° (3 cuartos), en Y es +90° (1 cuarto).
+Turn viewerTurn(Axis axis, int slice) {
+    uint8_t cw = (axis == Axis::Y) ? 1 : 3;
+    return Turn{ axis, (uint8_t)slice, (uint8_t)(g_counterClockwise ? 4 - cw : cw) };
+}
+
 void rotateFromActiveFace(int key) {
-    if (!g_rubiksCube) return;
+    if (!g_simulation) return;
 
     switch (g_activeFace) {
         // ================= FRONT =================
         case ActiveFace::FRONT:
-            if (key == GLFW_KEY_U) g_rubiksCube->rotateUpLayerClockwise();
-            if (key == GLFW_KEY_M) g_rubiksCube->rotateMiddleLayerClockwise();
-            if (key == GLFW_KEY_D) g_rubiksCube->rotateDownLayerClockwise();
-            if (key == GLFW_KEY_L) g_rubiksCube->rotateLeftLayerClockwise();
-            if (key == GLFW_KEY_V) g_rubiksCube->rotateMiddleVerticalClockwise();
-            if (key == GLFW_KEY_R) g_rubiksCube->rotateRightLayerClockwise();
+            if (key == GLFW_KEY_U) g_simulation->post(viewerTurn(Axis::Y, 2));
+            if (key == GLFW_KEY_M) g_simulation->post(viewerTurn(Axis::Y, 1));
+            if (key == GLFW_KEY_D) g_simulation->post(viewerTurn(Axis::Y, 0));
+            if (key == GLFW_KEY_L) g_simulation->post(viewerTurn(Axis::X, 0));
+            if (key == GLFW_KEY_V) g_simulation->post(viewerTurn(Axis::X, 1));
+            if (key == GLFW_KEY_R) g_simulation->post(viewerTurn(Axis::X, 2));
             break;
 
         // ================= BACK =================
         case ActiveFace::BACK:
-            if (key == GLFW_KEY_U) g_rubiksCube->rotateUpLayerClockwise();
-            if (key == GLFW_KEY_M) g_rubiksCube->rotateMiddleLayerClockwise();
-            if (key == GLFW_KEY_D) g_rubiksCube->rotateDownLayerClockwise();
-            if (key == GLFW_KEY_L) g_rubiksCube->rotateRightLayerClockwise();   // invertido
-            if (key == GLFW_KEY_V) g_rubiksCube->rotateMiddleVerticalClockwise();
-            if (key == GLFW_KEY_R) g_rubiksCube->rotateLeftLayerClockwise();    // invertido
+            if (key == GLFW_KEY_U) g_simulation->post(viewerTurn(Axis::Y, 2));
+            if (key == GLFW_KEY_M) g_simulation->post(viewerTurn(Axis::Y, 1));
+            if (key == GLFW_KEY_D) g_simulation->post(viewerTurn(Axis::Y, 0));
+            if (key == GLFW_KEY_L) g_simulation->post(viewerTurn(Axis::X, 2));   // invertido
+            if (key == GLFW_KEY_V) g_simulation->post(viewerTurn(Axis::X, 1));
+            if (key == GLFW_KEY_R) g_simulation->post(viewerTurn(Axis::X, 0));    // invertido
             break;
 
         // ================= LEFT =================
         case ActiveFace::LEFT:
-            if (key == GLFW_KEY_U) g_rubiksCube->rotateUpLayerClockwise();
-            if (key == GLFW_KEY_M) g_rubiksCube->rotateMiddleLayerClockwise();
-            if (key == GLFW_KEY_D) g_rubiksCube->rotateDownLayerClockwise();
-            if (key == GLFW_KEY_L) g_rubiksCube->rotateBackLayerClockwise();    // izquierda se convierte en back
-            if (key == GLFW_KEY_V) g_rubiksCube->rotateMiddleDepthClockwise();
-            if (key == GLFW_KEY_R) g_rubiksCube->rotateFrontLayerClockwise();   // derecha se convierte en front
+            if (key == GLFW_KEY_U) g_simulation->post(viewerTurn(Axis::Y, 2));
+            if (key == GLFW_KEY_M) g_simulation->post(viewerTurn(Axis::Y, 1));
+            if (key == GLFW_KEY_D) g_simulation->post(viewerTurn(Axis::Y, 0));
+            if (key == GLFW_KEY_L) g_simulation->post(viewerTurn(Axis::Z, 0));    // izquierda se convierte en back
+            if (key == GLFW_KEY_V) g_simulation->post(viewerTurn(Axis::Z, 1));
+            if (key == GLFW_KEY_R) g_simulation->post(viewerTurn(Axis::Z, 2));   // derecha se convierte en front
             break;
 
         // ================= RIGHT =================
         case ActiveFace::RIGHT:
-            if (key == GLFW_KEY_U) g_rubiksCube->rotateUpLayerClockwise();
-            if (key == GLFW_KEY_M) g_rubiksCube->rotateMiddleLayerClockwise();
-            if (key == GLFW_KEY_D) g_rubiksCube->rotateDownLayerClockwise();
-            if (key == GLFW_KEY_L) g_rubiksCube->rotateFrontLayerClockwise();   // izquierda es front
-            if (key == GLFW_KEY_V) g_rubiksCube->rotateMiddleDepthClockwise();
-            if (key == GLFW_KEY_R) g_rubiksCube->rotateBackLayerClockwise();    // derecha es back
+            if (key == GLFW_KEY_U) g_simulation->post(viewerTurn(Axis::Y, 2));
+            if (key == GLFW_KEY_M) g_simulation->post(viewerTurn(Axis::Y, 1));
+            if (key == GLFW_KEY_D) g_simulation->post(viewerTurn(Axis::Y, 0));
+            if (key == GLFW_KEY_L) g_simulation->post(viewerTurn(Axis::Z, 2));   // izquierda es front
+            if (key == GLFW_KEY_V) g_simulation->post(viewerTurn(Axis::Z, 1));
+            if (key == GLFW_KEY_R) g_simulation->post(viewerTurn(Axis::Z, 0));    // derecha es back
             break;
 
         // ================= UP =================
         case ActiveFace::UP:
-            if (key == GLFW_KEY_U) g_rubiksCube->rotateBackLayerClockwise();    // arriba mira hacia back
-            if (key == GLFW_KEY_M) g_rubiksCube->rotateMiddleDepthClockwise();
-            if (key == GLFW_KEY_D) g_rubiksCube->rotateFrontLayerClockwise();   // abajo mira hacia front
-            if (key == GLFW_KEY_L) g_rubiksCube->rotateLeftLayerClockwise();
-            if (key == GLFW_KEY_V) g_rubiksCube->rotateMiddleVerticalClockwise();
-            if (key == GLFW_KEY_R) g_rubiksCube->rotateRightLayerClockwise();
+            if (key == GLFW_KEY_U) g_simulation->post(viewerTurn(Axis::Z, 0));    // arriba mira hacia back
+            if (key == GLFW_KEY_M) g_simulation->post(viewerTurn(Axis::Z, 1));
+            if (key == GLFW_KEY_D) g_simulation->post(viewerTurn(Axis::Z, 2));   // abajo mira hacia front
+            if (key == GLFW_KEY_L) g_simulation->post(viewerTurn(Axis::X, 0));
+            if (key == GLFW_KEY_V) g_simulation->post(viewerTurn(Axis::X, 1));
+            if (key == GLFW_KEY_R) g_simulation->post(viewerTurn(Axis::X, 2));
             break;
 
         // ================= DOWN =================
         case ActiveFace::DOWN:
-            if (key == GLFW_KEY_U) g_rubiksCube->rotateFrontLayerClockwise();   // arriba mira hacia front
-            if (key == GLFW_KEY_M) g_rubiksCube->rotateMiddleDepthClockwise();
-            if (key == GLFW_KEY_D) g_rubiksCube->rotateBackLayerClockwise();    // abajo mira hacia back
-            if (key == GLFW_KEY_L) g_rubiksCube->rotateLeftLayerClockwise();
-            if (key == GLFW_KEY_V) g_rubiksCube->rotateMiddleVerticalClockwise();
-            if (key == GLFW_KEY_R) g_rubiksCube->rotateRightLayerClockwise();
+            if (key == GLFW_KEY_U) g_simulation->post(viewerTurn(Axis::Z, 2));   // arriba mira hacia front
+            if (key == GLFW_KEY_M) g_simulation->post(viewerTurn(Axis::Z, 1));
+            if (key == GLFW_KEY_D) g_simulation->post(viewerTurn(Axis::Z, 0));    // abajo mira hacia back
+            if (key == GLFW_KEY_L) g_simulation->post(viewerTurn(Axis::X, 0));
+            if (key == GLFW_KEY_V) g_simulation->post(viewerTurn(Axis::X, 1));
+            if (key == GLFW_KEY_R) g_simulation->post(viewerTurn(Axis::X, 2));
             break;
     }
 }
 
+//--------------------SOLVER ------------------------------
+
+// La misma cache que --batch --cache; nullptr si no se puede abrir (se resuelve sin ella)
+SolutionCache* sharedSolutionCache() {
+    static SolutionCache cache;
+    static const bool opened = cache.open(tablePath(SOLUTION_CACHE_FILE));
+    return opened ? &cache : nullptr;
+}
+
+// Resuelve `state` con el solver en dos fases, mirando antes en la cache de soluciones;
+// los giros salen en la notación del visor
+bool solveState(const CubeState& state, std::vector<Turn>& turns, std::ostream& log) {
+    CubieCube cube;
+    if (!cube.fromState(state)) {
+        log << "Estado invalido: no se puede resolver" << std::endl;
+        return false;
+    }
+    SolutionCache* cache = sharedSolutionCache();
+    TwoPhaseSolver::Result result;
+    const bool cached = cache && cache->find(cube, false, result.moves);
+    if (!cached) {
+        TwoPhaseSolver solver;
+        result = solver.solve(cube);
+        if (!result.found) return false;
+        if (cache) cache->store(cube, result.moves, false);
+    }
+
+    turns.clear();
+    std::string text;
+    for (int m : result.moves) {
+        turns.push_back(moveToTurn(m));
+        text += moveToString(m) + " ";
+    }
+    log << "Solucion (" << result.moves.size() << " giros, ";
+    if (cached) log << "de la cache";
+    else log << result.ms << " ms, " << result.nodes << " nodos";
+    log << "): " << text << std::endl;
+    return true;
+}
+
+// Solucion pedida con ENTER: es una tarea interactiva del planificador (adelanta a las de
+// fondo) y el bucle principal la recoge al terminar, asi la ventana no se congela
+struct SolveRequest
+{
+    std::mutex mutex;
+    bool busy = false;      // hay una tarea en marcha
+    bool ready = false;     // ha terminado: found y solution son validos
+    bool found = false;
+    CubeState state;        // estado que se pidio resolver
+    std::vector<Turn> solution;
+};
+SolveRequest g_solveRequest;
+
+void requestSolve(const CubeState& state) {
+    static TaskGroup tasks(TaskScheduler::instance());
+    {
+        std::lock_guard<std::mutex> lock(g_solveRequest.mutex);
+        if (g_solveRequest.busy) {
+            std::cout << "Ya se esta resolviendo" << std::endl;
+            return;
+        }
+        g_solveRequest.busy = true;
+        g_solveRequest.state = state;
+    }
+    tasks.run(TaskPriority::Interactive, [state] {
+        std::vector<Turn> solution;
+        const bool found = solveState(state, solution, std::cout);
+        std::lock_guard<std::mutex> lock(g_solveRequest.mutex);
+        g_solveRequest.found = found;
+        g_solveRequest.solution = std::move(solution);
+        g_solveRequest.ready = true;
+    });
+}
+
+// Desde el bucle principal: manda la solucion entera a la simulacion (que marca el ritmo de
+// la animacion) si el cubo, cuando acabe lo que se esta animando, sigue como cuando se pidio
+void collectSolve(const CubeState& current) {
+    std::lock_guard<std::mutex> lock(g_solveRequest.mutex);
+    if (!g_solveRequest.ready) return;
+    g_solveRequest.ready = g_solveRequest.busy = false;
+    if (!g_solveRequest.found) return;
+    if (current == g_solveRequest.state)
+        g_simulation->post(g_solveRequest.solution);
+    else
+        std::cout << "El cubo ha cambiado mientras se resolvia: pulsa ENTER otra vez" << std::endl;
+}
+
+// Contadores del planificador comun
+void printSchedulerCounters(std::ostream& out) {
+    const TaskScheduler::Counters c = TaskScheduler::instance().counters();
+    out << "Planificador: " << c.threads << " hilos  " << c.executed << " tareas  " << c.steals << " robadas  ocio "
+        << c.idleMs << " ms  en cola " << c.queued[(int)TaskPriority::Interactive] << " interactivas / "
+        << c.queued[(int)TaskPriority::Background] << " de fondo (max " << c.maxQueued << ")" << std::endl;
+}
+
+// n giros de cara aleatorios (sin repetir cara seguida)
+std::vector<Turn> randomScramble(int n, uint32_t& seed) {
+    std::vector<Turn> turns;
+    int lastFace = -1;
+    while ((int)turns.size() < n) {
+        seed = seed * 1664525u + 1013904223u;
+        int m = (int)((seed >> 8) % NUM_MOVES);
+        if (m / 3 == lastFace) continue;
+        lastFace = m / 3;
+        turns.push_back(moveToTurn(m));
+    }
+    return turns;
+}
+
 //--------------------CALLBACKS ------------------------------
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
@@ -806,6 +499,18 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 						  << std::endl;
 				break;
 
+			case GLFW_KEY_I:
+				std::cout << "Uniforms (ultimo frame): emitidos " << g_uniformStats.issued
+						  << ", omitidos " << g_uniformStats.skipped << std::endl;
+				printSchedulerCounters(std::cout);
+				if (g_simulation) {
+					const CubeSimulation::Stats sim = g_simulation->stats();
+					std::cout << "Simulacion: " << sim.applied << " giros aplicados de " << sim.received
+							  << " recibidos en " << sim.batches << " lotes, encolar " << sim.queue.meanPushNs
+							  << " ns de media" << std::endl;
+				}
+				break;
+
 			// ---------------- SELECCIÓN DE CARA ACTIVA ----------------
             case GLFW_KEY_1: g_activeFace = ActiveFace::FRONT; std::cout << "Cara activa: FRONT\n"; break;
             case GLFW_KEY_2: g_activeFace = ActiveFace::BACK;  std::cout << "Cara activa: BACK\n"; break;
@@ -832,6 +537,24 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
         keyProcessed[key] = true;
         switch (key) {
             case GLFW_KEY_ESCAPE: glfwSetWindowShouldClose(window, true); break;
+
+            // ---------------- MEZCLAR / RESOLVER ----------------
+            case GLFW_KEY_X: {
+                static uint32_t seed = (uint32_t)std::time(nullptr);
+                g_simulation->post(randomScramble(25, seed));
+                std::cout << "Cubo mezclado" << std::endl;
+                break;
+            }
+            case GLFW_KEY_T: {
+                // Guion largo: se aplica entero en el hilo de simulacion, el render no se para
+                static uint32_t seed = 777u;
+                g_simulation->post(randomScramble(STRESS_SCRIPT_LENGTH, seed));
+                std::cout << "Guion de " << STRESS_SCRIPT_LENGTH << " giros enviado" << std::endl;
+                break;
+            }
+            case GLFW_KEY_ENTER:
+                requestSolve(g_simulation->snapshot().target);
+                break;
         }
     }
     if (action == GLFW_RELEASE) {
@@ -840,8 +563,606 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 }
 
 
+// --- BENCHMARK DEL MOTOR DE GIROS ---
+// Aplica n giros pseudoaleatorios (todas las capas, ambos sentidos y medias vueltas)
+void runTurnBenchmark(long n) {
+    // Secuencia precalculada para no medir el generador aleatorio
+    std::vector<Turn> turns(4096);
+    uint32_t seed = 12345u;
+    for (Turn& t : turns) {
+        seed = seed * 1664525u + 1013904223u;
+        t = Turn{ (Axis)((seed >> 8) % 3), (uint8_t)((seed >> 12) % 3), (uint8_t)(1 + (seed >> 16) % 3) };
+    }
+
+    CubeState state;
+    auto t0 = std::chrono::steady_clock::now();
+    for (long i = 0; i < n; ++i)
+        state.turn(turns[i & 4095]);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << "Giros: " << n << "  tiempo: " << secs << " s  -> "
+              << (n / secs / 1e6) << " M giros/s"
+              << "  (resuelto: " << (state.isSolved() ? "si" : "no") << ")" << std::endl;
+}
+
+
+// --- BENCHMARK DEL SOLVER ---
+// Resuelve n mezclas aleatorias de 30 giros; las tablas se generan antes de medir
+void runSolveBenchmark(int n) {
+    auto t0 = std::chrono::steady_clock::now();
+    TwoPhaseSolver solver;
+    double init = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    uint32_t seed = 12345u;
+    double total = 0.0, worst = 0.0;
+    long moves = 0, nodes = 0;
+    for (int i = 0; i < n; ++i) {
+        CubeState state;
+        for (const Turn& t : randomScramble(30, seed)) state.turn(t);
+        CubieCube cube;
+        cube.fromState(state);
+        TwoPhaseSolver::Result result = solver.solve(cube);
+
+        for (int m : result.moves) state.turn(moveToTurn(m));
+        if (!result.found || !state.isSolved()) {
+            std::cout << "ERROR: la solucion " << i << " no resuelve el cubo" << std::endl;
+            return;
+        }
+        total += result.ms;
+        worst = std::max(worst, result.ms);
+        moves += (long)result.moves.size();
+        nodes += result.nodes;
+    }
+    const TwoPhaseTables& tables = TwoPhaseTables::get();
+    std::cout << "Tablas: " << init << " ms (" << tableOriginName(tables.origin) << ", " << tables.path << ")" << std::endl;
+    std::cout << "Resueltos: " << n << "  medio: " << total / n << " ms  max: " << worst << " ms"
+              << "  giros medios: " << (double)moves / n << "  nodos medios: " << nodes / n << std::endl;
+}
+
+
+// --- SOLVER ÓPTIMO ---
+// --optimal "R U F' ..." | --optimal N  [byte|nibble|mod3]: solucion minima de una mezcla
+// dada o de N giros aleatorios, con las tablas en la codificacion indicada. Imprime los
+// nodos de cada iteracion de IDA* y los nodos por segundo.
+bool parseEncoding(const std::string& name, TableEncoding& encoding) {
+    for (TableEncoding e : { TableEncoding::Byte, TableEncoding::Nibble, TableEncoding::Mod3 })
+        if (name == tableEncodingName(e)) {
+            encoding = e;
+            return true;
+        }
+    std::cout << "Codificacion invalida: " << name << " (byte, nibble o mod3)" << std::endl;
+    return false;
+}
+
+int runOptimal(const char* arg, TableEncoding encoding) {
+    std::vector<Turn> scramble;
+    int randomLength = std::atoi(arg);
+    if (randomLength > 0) {
+        uint32_t seed = (uint32_t)std::time(nullptr);
+        scramble = randomScramble(randomLength, seed);
+    } else if (!parseMoves(arg, scramble)) {
+        std::cout << "Secuencia invalida: " << arg << std::endl;
+        return -1;
+    }
+
+    CubeState state;
+    std::string text;
+    for (const Turn& t : scramble) {
+        state.turn(t);
+        text += turnToString(t) + " ";
+    }
+    std::cout << "Mezcla: " << text << std::endl;
+    CubieCube cube;
+    if (!cube.fromState(state)) return -1;
+
+    auto t0 = std::chrono::steady_clock::now();
+    OptimalSolver solver(encoding, &TaskScheduler::instance());
+    double init = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    const OptimalTables& tables = OptimalTables::get(encoding);
+    std::cout << "Tablas: " << init << " ms, " << tableOriginName(tables.origin) << " (" << tables.path
+              << ")  profundidad max: esquinas " << tables.corners.maxDepth()
+              << ", aristas " << tables.edgesLow.maxDepth() << "/" << tables.edgesHigh.maxDepth() << std::endl;
+
+    OptimalSolver::Result result = solver.solve(cube);
+    if (!result.found) {
+        std::cout << "Sin solucion en " << OptimalSolver::MAX_DEPTH << " giros" << std::endl;
+        return -1;
+    }
+    for (size_t d = 0; d < result.nodesPerDepth.size(); ++d)
+        if (result.nodesPerDepth[d] > 0)
+            std::cout << "  cota " << d << ": " << result.nodesPerDepth[d] << " nodos" << std::endl;
+
+    text.clear();
+    for (int m : result.moves) {
+        state.turn(moveToTurn(m));
+        text += moveToString(m) + " ";
+    }
+    std::cout << "Solucion optima (" << result.moves.size() << " giros): " << text
+              << (state.isSolved() ? "" : " [ERROR: no resuelve]") << std::endl;
+    std::cout << result.ms << " ms  " << result.nodes << " nodos  "
+              << (result.ms > 0.0 ? result.nodes / result.ms / 1000.0 : 0.0) << " Mnodos/s  (" << solver.threads()
+              << " hilos)" << std::endl;
+    return state.isSolved() ? 0 : -1;
+}
+
+
+// --- BENCHMARK DEL SOLVER ÓPTIMO ---
+// --bench-optimal [n] [largo]: las mismas n mezclas con cada codificacion de las tablas.
+// Las distancias son exactas en las tres, asi que los nodos deben coincidir; solo cambian
+// la memoria y los nodos por segundo.
+void runOptimalBenchmark(int n, int length) {
+    std::vector<CubieCube> cubes;
+    uint32_t seed = 12345u;
+    for (int i = 0; i < n; ++i) {
+        CubeState state;
+        for (const Turn& t : randomScramble(length, seed)) state.turn(t);
+        CubieCube cube;
+        cube.fromState(state);
+        cubes.push_back(cube);
+    }
+
+    long referenceNodes = -1;
+    for (TableEncoding e : { TableEncoding::Byte, TableEncoding::Nibble, TableEncoding::Mod3 }) {
+        auto t0 = std::chrono::steady_clock::now();
+        OptimalSolver solver(e);
+        double init = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        const OptimalTables& tables = OptimalTables::get(e);
+        const size_t bytes = tables.corners.bytes() + tables.edgesLow.bytes() + tables.edgesHigh.bytes();
+
+        double ms = 0.0;
+        long nodes = 0, moves = 0;
+        for (const CubieCube& cube : cubes) {
+            OptimalSolver::Result result = solver.solve(cube);
+            if (!result.found) {
+                std::cout << "ERROR: sin solucion con " << tableEncodingName(e) << std::endl;
+                return;
+            }
+            ms += result.ms;
+            nodes += result.nodes;
+            moves += (long)result.moves.size();
+        }
+        std::cout << tableEncodingName(e) << ": " << bytes / (1024 * 1024) << " MB  tablas " << init << " ms ("
+                  << tableOriginName(tables.origin) << ")  " << ms << " ms  " << nodes << " nodos  "
+                  << (ms > 0.0 ? nodes / ms / 1000.0 : 0.0) << " Mnodos/s  giros medios " << (double)moves / n
+                  << (referenceNodes >= 0 && nodes != referenceNodes ? "  [ERROR: nodos distintos]" : "") << std::endl;
+        if (referenceNodes < 0) referenceNodes = nodes;
+    }
+}
+
+
+// --- ESCALADO DEL SOLVER ÓPTIMO ---
+// --bench-threads [max] [n] [largo]: las mismas n mezclas con 1, 2, 4, ... max hilos, cada
+// vez con un planificador propio. Comprueba que la solucion no depende del numero de hilos.
+void runThreadBenchmark(int maxThreads, int n, int length) {
+    std::vector<CubieCube> cubes;
+    uint32_t seed = 54321u;
+    for (int i = 0; i < n; ++i) {
+        CubeState state;
+        for (const Turn& t : randomScramble(length, seed)) state.turn(t);
+        CubieCube cube;
+        cube.fromState(state);
+        cubes.push_back(cube);
+    }
+    OptimalTables::get();
+
+    std::vector<int> counts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) counts.push_back(threads);
+    counts.push_back(std::max(1, maxThreads));
+
+    std::vector<std::vector<int>> reference;
+    double baseMs = 0.0;
+    for (int threads : counts) {
+        TaskScheduler scheduler(threads);
+        OptimalSolver solver(TableEncoding::Byte, &scheduler);
+        double ms = 0.0;
+        long nodes = 0;
+        bool same = true;
+        for (int i = 0; i < n; ++i) {
+            OptimalSolver::Result result = solver.solve(cubes[i]);
+            ms += result.ms;
+            nodes += result.nodes;
+            if (threads == 1) reference.push_back(result.moves);
+            else same = same && result.moves == reference[i];
+        }
+        if (threads == 1) baseMs = ms;
+        std::cout << threads << " hilos: " << ms << " ms  aceleracion " << (ms > 0.0 ? baseMs / ms : 0.0) << "x  "
+                  << nodes << " nodos  " << (ms > 0.0 ? nodes / ms / 1000.0 : 0.0) << " Mnodos/s  "
+                  << scheduler.counters().steals << " tareas robadas"
+                  << (same ? "" : "  [ERROR: solucion distinta]") << std::endl;
+    }
+}
+
+
+// --- SIMULACION EN SU HILO ---
+// --bench-sim [n]: manda n giros a una CubeSimulation mientras otro hilo hace de render
+// recogiendo instantaneas sin parar, en tres casos: un productor con una mezcla al azar,
+// uno con cada giro repetido (se juntan al sacarlos de la cola) y tres productores a la
+// vez, cada uno en una capa del eje X (conmutan, asi que el orden no cambia el final).
+// Comprueba el estado final y muestra la latencia de la cola y cuanto se junta.
+int runSimulationBenchmark(int n) {
+    uint32_t seed = 2024u;
+    std::vector<Turn> random = randomScramble(n, seed);
+    std::vector<Turn> repeated;
+    for (int i = 0; (int)repeated.size() < n; ++i) {
+        repeated.push_back(random[i]);
+        if ((int)repeated.size() < n) repeated.push_back(random[i]);
+    }
+    const int PRODUCERS = 3;
+    std::vector<std::vector<Turn>> layers(PRODUCERS);
+    for (int i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        layers[i % PRODUCERS].push_back(Turn{ Axis::X, (uint8_t)(i % PRODUCERS), (uint8_t)(1 + (seed >> 8) % 3) });
+    }
+
+    const char* names[3] = { "1 productor:      ", "giros repetidos:  ", "3 productores:    " };
+    bool ok = true;
+    for (int mode = 0; mode < 3; ++mode) {
+        CubeState expected;
+        if (mode == 2) {
+            for (const std::vector<Turn>& layer : layers)
+                for (const Turn& t : layer) expected.turn(t);
+        }
+        else {
+            for (const Turn& t : mode == 0 ? random : repeated) expected.turn(t);
+        }
+
+        CubeSimulation simulation;
+        std::atomic<bool> done(false);
+        long reads = 0, snapshots = 0;
+        std::thread render([&] {
+            for (;;) {
+                const bool last = done.load();
+                reads++;
+                if (simulation.update()) snapshots++;
+                if (last) break;
+                std::this_thread::yield();
+            }
+        });
+
+        auto t0 = std::chrono::steady_clock::now();
+        if (mode == 2) {
+            std::vector<std::thread> producers;
+            for (const std::vector<Turn>& layer : layers) producers.emplace_back([&simulation, &layer] { simulation.post(layer); });
+            for (std::thread& t : producers) t.join();
+        }
+        else {
+            simulation.post(mode == 0 ? random : repeated);
+        }
+        while (simulation.processed() < (uint64_t)n) std::this_thread::yield();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        done = true;
+        render.join();
+
+        const CubeSimulation::Stats stats = simulation.stats();
+        const bool same = simulation.snapshot().state == expected && simulation.snapshot().processed == (uint64_t)n;
+        ok = ok && same;
+        std::cout << names[mode] << n << " giros en " << ms << " ms  (" << (ms > 0.0 ? n / ms / 1000.0 : 0.0)
+                  << " Mgiros/s)  encolar: media " << stats.queue.meanPushNs << " ns, max " << stats.queue.maxPushNs / 1000.0
+                  << " us, " << stats.queue.fullWaits << " con la cola llena" << std::endl;
+        std::cout << "                   aplicados " << stats.applied << " de " << stats.received << " ("
+                  << (stats.received ? 100.0 * stats.applied / stats.received : 0.0) << "%) en " << stats.batches
+                  << " lotes  render: " << reads << " lecturas, " << snapshots << " instantaneas nuevas"
+                  << (same ? "" : "  [ERROR: estado final distinto]") << std::endl;
+    }
+    return ok ? 0 : -1;
+}
+
+
+// --- MODO POR LOTES ---
+// --batch [FICHERO|-] [--optimal [byte|nibble|mod3]] [--threads N] [--pin N] [--window N] [--cache]
+// Una solucion por linea en stdout, en el orden de entrada; el resumen va a stderr.
+// --threads y --pin dan el tamano del planificador y los nucleos a los que se fijan sus hilos.
+// --cache usa (o crea) cubi_solutions.cache en el directorio de las tablas.
+int runBatch(int argc, char** argv) {
+    BatchSolver::Options options;
+    std::string input = "-";
+    bool useCache = false;
+    int threads = 0, pinCores = -1;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--optimal") {
+            options.optimal = true;
+            if (hasValue && argv[i + 1][0] != '-') {
+                if (!parseEncoding(argv[++i], options.encoding)) return -1;
+            }
+        }
+        else if (arg == "--threads" && hasValue) threads = std::atoi(argv[++i]);
+        else if (arg == "--pin" && hasValue) pinCores = std::atoi(argv[++i]);
+        else if (arg == "--window" && hasValue) options.window = (size_t)std::atol(argv[++i]);
+        else if (arg == "--cache") useCache = true;
+        else if (arg[0] != '-' || arg == "-") input = arg;
+        else {
+            std::cerr << "Opcion desconocida: " << arg << std::endl;
+            return -1;
+        }
+    }
+
+    std::ifstream file;
+    if (input != "-") {
+        file.open(input);
+        if (!file) {
+            std::cerr << "No se puede abrir " << input << std::endl;
+            return -1;
+        }
+    }
+    SolutionCache cache;
+    if (useCache) {
+        if (cache.open(tablePath(SOLUTION_CACHE_FILE))) options.cache = &cache;
+        else std::cerr << "No se puede abrir la cache " << tablePath(SOLUTION_CACHE_FILE) << std::endl;
+    }
+    std::ios::sync_with_stdio(false);
+    TaskScheduler::configure(threads, pinCores);
+    BatchSolver batch(options);
+    BatchSolver::Stats stats = batch.run(input == "-" ? std::cin : file, std::cout);
+
+    std::cerr << "Resueltas: " << stats.solved << "  fallidas: " << stats.failed << "  en " << stats.seconds << " s  ("
+              << (stats.seconds > 0.0 ? stats.solved / stats.seconds : 0.0) << " resueltas por segundo, "
+              << TaskScheduler::instance().size() << " hilos, " << (options.optimal ? "optimo" : "dos fases")
+              << ")  tablas: " << stats.tableSeconds << " s" << std::endl;
+    std::cerr << "Latencia p50: " << stats.p50Ms << " ms  p99: " << stats.p99Ms << " ms  giros medios: "
+              << stats.meanLength << "  pico de memoria: " << stats.peakRssKb / 1024 << " MB" << std::endl;
+    if (options.cache) {
+        const SolutionCache::Stats c = cache.stats();
+        std::cerr << "Cache: " << c.hits << " aciertos de " << c.lookups << " ("
+                  << (c.lookups ? 100.0 * c.hits / c.lookups : 0.0) << "%)  consulta media " << c.meanLookupUs
+                  << " us  " << c.inserts << " guardadas  " << c.entries << "/" << c.slots << " entradas  fichero "
+                  << c.fileBytes / (1024 * 1024) << " MB" << (cache.canWrite() ? "" : " (solo lectura)") << std::endl;
+    }
+    printSchedulerCounters(std::cerr);
+    return stats.failed == 0 ? 0 : 1;
+}
+
+
+// --- FICHEROS DE TABLAS ---
+// --tables [--verify] [byte|nibble|mod3]: carga (o genera y guarda) las tablas de ambos
+// solvers y mide el arranque; si se generan, muestra el tiempo de cada capa de la BFS.
+// Con --verify comprueba ademas el checksum de todo el fichero
+int runTables(bool verify, TableEncoding encoding) {
+    auto t0 = std::chrono::steady_clock::now();
+    const CoordMoveTables& moves = CoordMoveTables::get();
+    auto tm = std::chrono::steady_clock::now();
+    const TwoPhaseTables& twoPhase = TwoPhaseTables::get();
+    auto t1 = std::chrono::steady_clock::now();
+    const OptimalTables& optimal = OptimalTables::get(encoding);
+    auto t2 = std::chrono::steady_clock::now();
+    std::cout << "Giros:     " << std::chrono::duration<double, std::milli>(tm - t0).count() << " ms, "
+              << tableOriginName(moves.origin) << " (" << moves.path << ")" << std::endl;
+    std::cout << "Dos fases: " << std::chrono::duration<double, std::milli>(t1 - tm).count() << " ms, "
+              << tableOriginName(twoPhase.origin) << " (" << twoPhase.path << ")" << std::endl;
+    std::cout << "Optimo:    " << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms, "
+              << tableOriginName(optimal.origin) << " (" << optimal.path << ")" << std::endl;
+
+    const char* names[3] = { "esquinas", "aristas UR..DF", "aristas DL..BR" };
+    for (int k = 0; k < 3; ++k) {
+        if (optimal.generationStats[k].empty()) continue;
+        std::cout << "  " << names[k] << " (" << TaskScheduler::instance().size() << " hilos):" << std::endl;
+        for (const PatternDatabase::LayerStats& layer : optimal.generationStats[k])
+            std::cout << "    capa " << layer.depth << (layer.backward ? " (atras)  " : " (delante)") << ": "
+                      << layer.states << " estados  " << layer.ms << " ms  "
+                      << (layer.ms > 0.0 ? layer.states / layer.ms / 1000.0 : 0.0) << " Mestados/s" << std::endl;
+    }
+    if (!verify) return 0;
+
+    bool ok = moves.verify() && twoPhase.verify() && optimal.verify();
+    std::cout << "Checksums: " << (ok ? "correctos" : "ERROR (borra los ficheros para regenerarlos)") << " ("
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t2).count() << " ms)"
+              << std::endl;
+    return ok ? 0 : -1;
+}
+
+
+// --- FRAME COMÚN (ventana y headless) ---
+void renderFrame(Shader& shader, CameraUBO& camera, RubiksCube& cube) {
+    glClearColor(0.8f, 0.8f, 0.8f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    Vec3 eye = g_cameraPos;
+    Vec3 center(g_cameraPos.x, g_cameraPos.y, g_cameraPos.z - 1.0f);
+    Vec3 up(0.0f, 1.0f, 0.0f);
+
+    // Solo re-sube el UBO si la cámara se movió
+    camera.setLookAt(eye, center, up);
+    camera.update();
+
+    shader.use();
+    shader.resetStats();
+    cube.draw(shader);
+    g_uniformStats = shader.stats();
+}
+
+
+// --- MODO HEADLESS ---
+// --headless [--frames N] [--size WxH] [--out DIR | --raw FILE]
+//            [--scramble "R U F'"] [--moves "R U" | --solve] [--anim N]
+// Dibuja en un FBO sin ventana ni X11. Con --out escribe DIR/frame_0000.ppm, ...;
+// con --raw escribe RGBA crudo ("-" = stdout) para un codificador de video.
+// --moves aplica un giro por frame (cíclico); --solve reproduce la solución del solver.
+// --anim N reparte cada giro en N frames, girando la capa en el vertex shader.
+#ifdef CUBI_HAVE_EGL
+int runHeadless(int argc, char** argv) {
+    int frames = -1, width = SCR_WIDTH, height = SCR_HEIGHT, anim = 1;
+    std::string outDir, rawFile;
+    std::vector<Turn> scramble, moves;
+    bool solve = false;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--frames" && hasValue) frames = std::atoi(argv[++i]);
+        else if (arg == "--size" && hasValue) {
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+                std::cout << "Tamaño invalido: " << argv[i] << std::endl;
+                return -1;
+            }
+        }
+        else if (arg == "--out" && hasValue) outDir = argv[++i];
+        else if (arg == "--raw" && hasValue) rawFile = argv[++i];
+        else if (arg == "--solve") solve = true;
+        else if (arg == "--anim" && hasValue) anim = std::max(1, std::atoi(argv[++i]));
+        else if ((arg == "--scramble" || arg == "--moves") && hasValue) {
+            if (!parseMoves(argv[++i], arg == "--scramble" ? scramble : moves)) {
+                std::cout << "Secuencia invalida: " << argv[i] << std::endl;
+                return -1;
+            }
+        }
+        else {
+            std::cout << "Opcion desconocida: " << arg << std::endl;
+            return -1;
+        }
+    }
+
+    // Con --raw a stdout los mensajes van a stderr para no mezclarse con los píxeles
+    std::ostream& log = (rawFile == "-") ? std::cerr : std::cout;
+
+    // Solución guionizada: se resuelve la mezcla y se reproduce un giro por frame
+    if (solve) {
+        CubeState scrambled;
+        for (const Turn& t : scramble) scrambled.turn(t);
+        if (!solveState(scrambled, moves, log)) return -1;
+    }
+    if (frames < 0) frames = moves.empty() ? 1 : (int)moves.size() * anim + 1;
+
+    HeadlessContext context;
+    if (!context.create()) return -1;
+    log << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
+
+    OffscreenTarget target;
+    if (!target.create(width, height)) return -1;
+    target.bind();
+    glEnable(GL_DEPTH_TEST);
+
+    Shader cubieShader(vertexShaderSource, fragmentShaderSource);
+    CameraUBO camera;
+    camera.create();
+    camera.setViewport(width, height);
+    cubieShader.bindUniformBlock(CameraUBO::BLOCK_NAME, CameraUBO::BINDING);
+
+    RubiksCube rubiksCube;
+    rubiksCube.setupMesh(cubieShader);
+    for (const Turn& t : scramble) rubiksCube.turn(t);
+
+    FrameCapture capture;
+    bool capturing = !outDir.empty() || !rawFile.empty();
+    if (capturing) {
+        bool ok = rawFile.empty() ? capture.start(width, height, FrameCapture::Format::PPM, outDir)
+                                  : capture.start(width, height, FrameCapture::Format::RAW, rawFile);
+        if (!ok) return -1;
+    }
+
+    double total = 0.0, best = 1e30, worst = 0.0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int f = 0; f < frames; ++f) {
+        if (!moves.empty() && f > 0) {
+            // Frames 1..N-1 de cada giro: la capa a medio girar; en el N se aplica
+            const Turn& t = moves[((f - 1) / anim) % moves.size()];
+            const int step = (f - 1) % anim + 1;
+            if (step < anim) {
+                rubiksCube.setTurn(&t, turnAngle(t, (float)step / anim));
+            }
+            else {
+                rubiksCube.setTurn(nullptr, 0.0f);
+                rubiksCube.turn(t);
+            }
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        renderFrame(cubieShader, camera, rubiksCube);
+        if (capturing) {
+            // La lectura va a un PBO; se mapea el frame N-2 sin esperar a la GPU
+            capture.capture(target.id());
+        }
+        else {
+            // Sin captura, glFinish para que el tiempo incluya el rasterizado completo
+            glFinish();
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        total += ms;
+        best = std::min(best, ms);
+        worst = std::max(worst, ms);
+    }
+
+    capture.finish();
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (capture.failed()) {
+        log << "Error escribiendo frames en " << (rawFile.empty() ? outDir : rawFile) << std::endl;
+        return -1;
+    }
+    if (frames > 0) {
+        log << "Frames: " << frames << " (" << width << "x" << height << ")"
+            << "  medio: " << total / frames << " ms  min: " << best << " ms  max: " << worst << " ms"
+            << std::endl;
+        log << "Sostenido: " << (frames / wall) << " fps";
+        if (capturing) log << "  (" << capture.framesWritten() << " frames escritos)";
+        log << "  resuelto: " << (rubiksCube.state().isSolved() ? "si" : "no") << std::endl;
+    }
+    return 0;
+}
+#endif
+
+
 // --- 8. FUNCIÓN MAIN ---
-int main() {
+int main(int argc, char** argv) {
+    // --bench-turns [n]: mide el motor de giros sin abrir ventana
+    if (argc >= 2 && std::string(argv[1]) == "--bench-turns") {
+        runTurnBenchmark(argc >= 3 ? std::atol(argv[2]) : 100000000L);
+        return 0;
+    }
+
+    // --bench-solve [n]: mide el solver en dos fases sin abrir ventana
+    if (argc >= 2 && std::string(argv[1]) == "--bench-solve") {
+        runSolveBenchmark(argc >= 3 ? std::atoi(argv[2]) : 100);
+        return 0;
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "--tables") {
+        bool verify = false;
+        TableEncoding encoding = TableEncoding::Byte;
+        for (int i = 2; i < argc; ++i) {
+            if (std::string(argv[i]) == "--verify") verify = true;
+            else if (!parseEncoding(argv[i], encoding)) return -1;
+        }
+        return runTables(verify, encoding);
+    }
+
+    // --optimal "giros" | --optimal N: solver optimo sin abrir ventana
+    if (argc >= 3 && std::string(argv[1]) == "--optimal") {
+        TableEncoding encoding = TableEncoding::Byte;
+        if (argc >= 4 && !parseEncoding(argv[3], encoding)) return -1;
+        return runOptimal(argv[2], encoding);
+    }
+
+    // --batch [FICHERO|-] ...: resuelve una mezcla por linea sin abrir ventana
+    if (argc >= 2 && std::string(argv[1]) == "--batch") return runBatch(argc, argv);
+
+    // --bench-threads [max] [n] [largo]: escalado del solver optimo con el numero de hilos
+    if (argc >= 2 && std::string(argv[1]) == "--bench-threads") {
+        runThreadBenchmark(argc >= 3 ? std::atoi(argv[2]) : defaultThreadCount(), argc >= 4 ? std::atoi(argv[3]) : 5,
+                           argc >= 5 ? std::atoi(argv[4]) : 13);
+        return 0;
+    }
+
+    // --bench-sim [n]: giros aplicados por el hilo de simulacion mientras se recogen instantaneas
+    if (argc >= 2 && std::string(argv[1]) == "--bench-sim")
+        return runSimulationBenchmark(argc >= 3 ? std::atoi(argv[2]) : STRESS_SCRIPT_LENGTH);
+
+    // --bench-optimal [n] [largo]: compara las codificaciones de las tablas del solver optimo
+    if (argc >= 2 && std::string(argv[1]) == "--bench-optimal") {
+        runOptimalBenchmark(argc >= 3 ? std::atoi(argv[2]) : 10, argc >= 4 ? std::atoi(argv[3]) : 12);
+        return 0;
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "--headless") {
+#ifdef CUBI_HAVE_EGL
+        return runHeadless(argc, argv);
+#else
+        std::cout << "Compilado sin EGL: el modo --headless no esta disponible" << std::endl;
+        return -1;
+#endif
+    }
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -865,31 +1186,32 @@ int main() {
     glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
 
     Shader cubieShader(vertexShaderSource, fragmentShaderSource);
+    CameraUBO camera;
+    camera.create();
+    camera.setViewport(SCR_WIDTH, SCR_HEIGHT);
+    cubieShader.bindUniformBlock(CameraUBO::BLOCK_NAME, CameraUBO::BINDING);
 
     RubiksCube rubiksCube;
-    rubiksCube.setupMesh();
+    rubiksCube.setupMesh(cubieShader);
     g_rubiksCube = &rubiksCube;
+    CubeSimulation simulation(rubiksCube.state());
+    simulation.setTurnSeconds(TURN_SECONDS);
+    g_simulation = &simulation;
 
 
     while (!glfwWindowShouldClose(window)) {
-        glClearColor(0.8f, 0.8f, 0.8f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        Vec3 eye = g_cameraPos;
-        Vec3 center(g_cameraPos.x, g_cameraPos.y, g_cameraPos.z - 1.0f); 
-  
-        Vec3 up(0.0f, 1.0f, 0.0f);
+        collectSolve(simulation.snapshot().target);
 
-        Mat4 view = lookAt(eye, center, up);
-        Mat4 proj = perspective(45.0f, (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-        cubieShader.use();       
-		cubieShader.setMat4("projection", proj.m);
-        cubieShader.setMat4("view", view.m);
-        rubiksCube.draw(cubieShader);
+        // Sin esperar: si la simulacion publico algo nuevo se dibuja eso, si no lo de antes
+        if (simulation.update()) rubiksCube.setState(simulation.snapshot().state);
+        const CubeSnapshot& snapshot = simulation.snapshot();
+        rubiksCube.setTurn(snapshot.turning ? &snapshot.turn : nullptr, snapshot.turnAngle(CubeSnapshot::Clock::now()));
+        renderFrame(cubieShader, camera, rubiksCube);
 
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
+    g_simulation = nullptr;
 
     glfwTerminate();
     return 0;
@@ -0,0 +1,172 @@
+#ifndef MOVEQUEUE_H
+#define MOVEQUEUE_H
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+#include "cubeState.h"
+
+//------------------------------cola de giros MPSC--------------------------------------
+// Cola circular acotada sin cerrojos: varios hilos meten comandos (teclado, reproduccion
+// de soluciones, guiones...) y un solo consumidor, el hilo de simulacion, los saca por
+// lotes en el orden en que se reservaron sus huecos.
+//
+// Cada hueco lleva un numero de secuencia (esquema de Vyukov): el productor reserva una
+// posicion con un CAS sobre m_tail, escribe el comando y publica el hueco con su secuencia;
+// el consumidor lo lee cuando la secuencia dice que esta escrito y lo devuelve para la
+// vuelta siguiente. Con la cola llena, push cede el hilo hasta que haya sitio.
+
+struct MoveCommand
+{
+    enum Kind : uint8_t { TURN };
+
+    uint8_t kind;
+    Turn turn;      // eje, capa y cuartos de vuelta
+};
+
+static_assert(sizeof(MoveCommand) == 4, "MoveCommand debe ocupar 4 bytes");
+
+// Junta giros seguidos de la misma capa: R R R -> R', R R' -> nada. Como `out` hace de
+// pila, lo que se anula deja juntos a sus vecinos y tambien se combinan (R U U' R' -> nada).
+// `out` es cualquier contenedor con back/push_back/pop_back (vector, deque).
+template <typename Turns>
+inline void coalesceTurn(Turns& out, const Turn& t)
+{
+    if (!out.empty() && out.back().axis == t.axis && out.back().slice == t.slice) {
+        const uint8_t quarters = (uint8_t)((out.back().quarters + t.quarters) & 3);
+        if (quarters == 0) out.pop_back();
+        else out.back().quarters = quarters;
+    }
+    else if (t.quarters & 3) {
+        out.push_back(t);
+    }
+}
+
+class MoveQueue
+{
+public:
+    static const size_t DEFAULT_CAPACITY = 1 << 14;
+
+    struct Stats
+    {
+        uint64_t pushed = 0;
+        uint64_t fullWaits = 0;     // veces que un productor encontro la cola llena
+        double meanPushNs = 0.0;    // latencia de push, esperas incluidas
+        double maxPushNs = 0.0;
+    };
+
+    // capacity se redondea a potencia de 2
+    explicit MoveQueue(size_t capacity = DEFAULT_CAPACITY)
+        : m_cells(roundCapacity(capacity)), m_mask((uint32_t)(m_cells.size() - 1)), m_tail(0), m_head(0),
+          m_pushed(0), m_fullWaits(0), m_pushNs(0), m_maxPushNs(0)
+    {
+        for (uint32_t i = 0; i <= m_mask; ++i) m_cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    MoveQueue(const MoveQueue&) = delete;
+    MoveQueue& operator=(const MoveQueue&) = delete;
+
+    size_t capacity() const { return (size_t)m_mask + 1; }
+
+    // --- productores ---
+    bool tryPush(const MoveCommand& command)
+    {
+        uint32_t pos = m_tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = m_cells[pos & m_mask];
+            const int32_t diff = (int32_t)(cell.seq.load(std::memory_order_acquire) - pos);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.command = command;
+                    // seq_cst: el hilo de simulacion mira si hay algo antes de dormirse
+                    cell.seq.store(pos + 1, std::memory_order_seq_cst);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;   // llena: el hueco aun no lo ha leido el consumidor
+            }
+            else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Espera (cediendo el hilo) si esta llena; `onFull` se llama antes de cada espera
+    template <typename OnFull>
+    void push(const MoveCommand& command, OnFull onFull)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        if (!tryPush(command)) {
+            m_fullWaits.fetch_add(1, std::memory_order_relaxed);
+            do {
+                onFull();
+                std::this_thread::yield();
+            } while (!tryPush(command));
+        }
+        const uint64_t ns =
+            (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+        m_pushed.fetch_add(1, std::memory_order_relaxed);
+        m_pushNs.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t max = m_maxPushNs.load(std::memory_order_relaxed);
+        while (ns > max && !m_maxPushNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+    }
+
+    // --- consumidor (un solo hilo) ---
+    // Saca hasta `max` comandos en orden; se para en el primer hueco reservado sin escribir
+    size_t popBatch(MoveCommand* out, size_t max)
+    {
+        size_t n = 0;
+        while (n < max) {
+            Cell& cell = m_cells[m_head & m_mask];
+            if ((int32_t)(cell.seq.load(std::memory_order_acquire) - (m_head + 1)) < 0) break;
+            out[n++] = cell.command;
+            cell.seq.store(m_head + m_mask + 1, std::memory_order_release);
+            m_head++;
+        }
+        return n;
+    }
+
+    bool empty() const
+    {
+        return (int32_t)(m_cells[m_head & m_mask].seq.load(std::memory_order_seq_cst) - (m_head + 1)) < 0;
+    }
+
+    Stats stats() const
+    {
+        Stats s;
+        s.pushed = m_pushed.load(std::memory_order_relaxed);
+        s.fullWaits = m_fullWaits.load(std::memory_order_relaxed);
+        s.meanPushNs = s.pushed ? (double)m_pushNs.load(std::memory_order_relaxed) / s.pushed : 0.0;
+        s.maxPushNs = (double)m_maxPushNs.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<uint32_t> seq;
+        MoveCommand command;
+
+        Cell() : seq(0), command() {}
+    };
+
+    std::vector<Cell> m_cells;
+    uint32_t m_mask;
+    alignas(64) std::atomic<uint32_t> m_tail;       // siguiente posicion para un productor
+    alignas(64) uint32_t m_head;                    // siguiente posicion a leer (consumidor)
+    alignas(64) std::atomic<uint64_t> m_pushed, m_fullWaits, m_pushNs, m_maxPushNs;
+
+    static size_t roundCapacity(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        return size;
+    }
+};
+
+#endif
@@ -0,0 +1,471 @@
+#ifndef OPTIMAL_H
+#define OPTIMAL_H
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <bitset>
+
+#include "coordCube.h"
+#include "pruning.h"
+#include "symmetry.h"
+
+//------------------------------solver optimo (IDA*)------------------------------------
+// Soluciones de longitud minima en la metrica de giros de cara (HTM).
+// Heuristica = max de tres bases de patrones exactas:
+//   esquinas          2768 clases * 3^7  =  6.053.616 entradas (8! * 3^7 sin simetrias)
+//   aristas UR..DF    12!/6! * 2^6       = 42.577.920 entradas
+//   aristas DL..BR    12!/6! * 2^6       = 42.577.920 entradas
+// La de esquinas esta reducida por las 16 simetrias U-D (ver CornerSymmetry). Las tablas
+// se mapean de un fichero por codificacion (ver TableEncoding): ~91 MB en bytes, ~46 MB en
+// nibbles, ~23 MB en mod 3. Si no existe se genera la primera vez que se
+// pide, con todos los nucleos, directamente dentro del fichero.
+
+const uint32_t OPTIMAL_TABLE_VERSION = 2;   // subir si cambian las bases de patrones
+
+inline const char* optimalTableFile(TableEncoding e)
+{
+    return e == TableEncoding::Byte ? "cubi_optimal.tbl" : e == TableEncoding::Nibble ? "cubi_optimal_nibble.tbl"
+                                                                                      : "cubi_optimal_mod3.tbl";
+}
+
+//-------------------------coordenada de 3 aristas--------------------------------------
+// Posiciones (ordenadas, distintas) y orientaciones de 3 aristas concretas:
+// 12*11*10 * 2^3 = 10560 valores. La tabla de giros no depende de que aristas son,
+// asi que una sola tabla sirve para los 4 grupos (UR UF UL, UB DR DF, DL DB FR, FL BL BR).
+
+const int NUM_TRIPLE = 10560;
+const int NUM_TRIPLE_SETS = 220;          // C(12,3) conjuntos de posiciones
+const int NUM_TRIPLE_REL = 4032;          // 9*8*7 * 2^3: el 2º trio en las 9 posiciones libres
+const int NUM_CORNER_PDB = NUM_CORNER_CLASSES * NUM_TWIST;
+const int NUM_EDGE_PDB = NUM_TRIPLE * NUM_TRIPLE_REL;
+
+constexpr int encodeTriple(const int pos[3], const int ori[3])
+{
+    const int p1 = pos[1] - (pos[1] > pos[0]);
+    const int p2 = pos[2] - (pos[2] > pos[0]) - (pos[2] > pos[1]);
+    return ((pos[0] * 11 + p1) * 10 + p2) * 8 + ori[0] * 4 + ori[1] * 2 + ori[2];
+}
+
+constexpr void decodeTriple(int coord, int pos[3], int ori[3])
+{
+    ori[2] = coord & 1; ori[1] = (coord >> 1) & 1; ori[0] = (coord >> 2) & 1;
+    coord >>= 3;
+    int p2 = coord % 10; coord /= 10;
+    int p1 = coord % 11;
+    pos[0] = coord / 11;
+    pos[1] = p1 + (p1 >= pos[0]);
+    // p2 salta las dos posiciones ya ocupadas, de menor a mayor
+    const int lo = pos[0] < pos[1] ? pos[0] : pos[1], hi = pos[0] < pos[1] ? pos[1] : pos[0];
+    p2 += (p2 >= lo);
+    p2 += (p2 >= hi);
+    pos[2] = p2;
+}
+
+constexpr int getTriple(const CubieCube& c, int firstEdge)
+{
+    int pos[3] = {}, ori[3] = {};
+    for (int i = 0; i < NUM_EDGES; ++i) {
+        const int k = c.ep[i] - firstEdge;
+        if (k < 0 || k > 2) continue;
+        pos[k] = i;
+        ori[k] = c.eo[i];
+    }
+    return encodeTriple(pos, ori);
+}
+
+struct OptimalTables
+{
+    MoveTable<NUM_TRIPLE> tripleMove;
+    uint8_t tripleSet[NUM_TRIPLE];                            // conjunto de posiciones (0..219)
+    uint16_t rel[NUM_TRIPLE_SETS][NUM_TRIPLE];                // 2º trio -> 0..4031 (o 0xFFFF si choca)
+    uint16_t unrel[NUM_TRIPLE_SETS][NUM_TRIPLE_REL];          // inverso de rel
+    int solvedTriple[4];
+
+    PatternDatabase corners;
+    PatternDatabase edgesLow;    // UR UF UL UB DR DF
+    PatternDatabase edgesHigh;   // DL DB FR FL BL BR
+
+    TableEncoding encoding;
+    TableOrigin origin;
+    std::string path;
+    std::vector<PatternDatabase::LayerStats> generationStats[3];   // vacias si se mapearon
+
+    const PatternDatabase& database(int k) const { return k == 0 ? corners : k == 1 ? edgesLow : edgesHigh; }
+
+    static const OptimalTables& get(TableEncoding e = TableEncoding::Byte)
+    {
+        switch (e) {
+        case TableEncoding::Nibble: { static const OptimalTables tables(TableEncoding::Nibble); return tables; }
+        case TableEncoding::Mod3: { static const OptimalTables tables(TableEncoding::Mod3); return tables; }
+        default: { static const OptimalTables tables(TableEncoding::Byte); return tables; }
+        }
+    }
+
+    // Comprueba el checksum de cada seccion del fichero mapeado (lo lee entero)
+    bool verify() const { return !m_file.isOpen() || m_file.verify(); }
+
+    uint32_t cornerIndex(int cornerPerm, int twist) const { return m_cornerSym->index(cornerPerm, twist); }
+
+    uint32_t edgeIndex(int a, int b) const { return (uint32_t)a * NUM_TRIPLE_REL + rel[tripleSet[a]][b]; }
+
+    // Vecinos de una entrada de cada base de patrones (para generarlas y para exactDepth)
+    int expandCorners(uint32_t i, uint32_t* out) const
+    {
+        const MoveTable<NUM_CORNER_PERM>& cornerMove = *m_cornerMove;
+        const int cp = m_cornerSym->rep[i / NUM_TWIST], tw = (int)(i % NUM_TWIST);
+        for (int m = 0; m < NUM_MOVES; ++m) out[m] = cornerIndex(cornerMove[cp][m], TWIST_MOVE[tw][m]);
+        return NUM_MOVES;
+    }
+
+    int expandEdges(uint32_t i, uint32_t* out) const
+    {
+        const int a = (int)(i / NUM_TRIPLE_REL);
+        const int b = unrel[tripleSet[a]][i % NUM_TRIPLE_REL];
+        for (int m = 0; m < NUM_MOVES; ++m) out[m] = edgeIndex(tripleMove[a][m], tripleMove[b][m]);
+        return NUM_MOVES;
+    }
+
+    // Distancias exactas (la de las tres tablas), validas con cualquier codificacion
+    void exactDepths(uint32_t corner, uint32_t low, uint32_t high, int out[3]) const
+    {
+        auto expandC = [this](uint32_t i, uint32_t* o) { return expandCorners(i, o); };
+        auto expandE = [this](uint32_t i, uint32_t* o) { return expandEdges(i, o); };
+        out[0] = corners.exactDepth(corner, cornerIndex(0, 0), expandC);
+        out[1] = edgesLow.exactDepth(low, edgeIndex(solvedTriple[0], solvedTriple[1]), expandE);
+        out[2] = edgesHigh.exactDepth(high, edgeIndex(solvedTriple[2], solvedTriple[3]), expandE);
+    }
+
+private:
+    explicit OptimalTables(TableEncoding e)
+        : encoding(e), m_cornerMove(&cornerPermMove()), m_cornerSym(&cornerSymmetry())
+    {
+        buildTripleTables();
+        for (int g = 0; g < 4; ++g) solvedTriple[g] = getTriple(CubieCube::identity(), g * 3);
+
+        path = tablePath(optimalTableFile(e));
+        if (m_file.open(path, OPTIMAL_TABLE_VERSION) &&
+            corners.attach(m_file, "corners", NUM_CORNER_PDB, e) &&
+            edgesLow.attach(m_file, "edgesLow", NUM_EDGE_PDB, e) &&
+            edgesHigh.attach(m_file, "edgesHigh", NUM_EDGE_PDB, e)) {
+            origin = TableOrigin::Mapped;
+            return;
+        }
+        m_file.close();
+
+        // Se genera directamente dentro del fichero; si no se puede crear, en memoria
+        const size_t cornerBytes = PatternDatabase::storageBytes(e, NUM_CORNER_PDB);
+        const size_t edgeBytes = PatternDatabase::storageBytes(e, NUM_EDGE_PDB);
+        TableFileBuilder builder;
+        builder.declare("corners", cornerBytes);
+        builder.declare("corners.capas", PatternDatabase::LAYERS_BYTES);
+        builder.declare("edgesLow", edgeBytes);
+        builder.declare("edgesLow.capas", PatternDatabase::LAYERS_BYTES);
+        builder.declare("edgesHigh", edgeBytes);
+        builder.declare("edgesHigh.capas", PatternDatabase::LAYERS_BYTES);
+        const bool toFile = builder.create(path, OPTIMAL_TABLE_VERSION);
+
+        generate(e, (uint8_t*)builder.section("corners"), (uint8_t*)builder.section("edgesLow"),
+                 (uint8_t*)builder.section("edgesHigh"));
+        if (toFile) {
+            corners.storeLayers(builder.section("corners.capas"));
+            edgesLow.storeLayers(builder.section("edgesLow.capas"));
+            edgesHigh.storeLayers(builder.section("edgesHigh.capas"));
+            // Las estadisticas de generacion se pierden al pasar al fichero de solo lectura
+            std::vector<PatternDatabase::LayerStats> stats[3] = { corners.buildStats(), edgesLow.buildStats(),
+                                                                  edgesHigh.buildStats() };
+            if (builder.commit() && m_file.open(path, OPTIMAL_TABLE_VERSION) &&
+                corners.attach(m_file, "corners", NUM_CORNER_PDB, e) &&
+                edgesLow.attach(m_file, "edgesLow", NUM_EDGE_PDB, e) &&
+                edgesHigh.attach(m_file, "edgesHigh", NUM_EDGE_PDB, e)) {
+                generationStats[0] = stats[0];
+                generationStats[1] = stats[1];
+                generationStats[2] = stats[2];
+                origin = TableOrigin::Generated;
+                return;
+            }
+            m_file.close();
+            generate(e, nullptr, nullptr, nullptr);
+        }
+        for (int k = 0; k < 3; ++k) generationStats[k] = database(k).buildStats();
+        origin = TableOrigin::GeneratedNotSaved;
+    }
+
+    // Byte y Nibble se generan con la BFS en paralelo; Mod3 se comprime de la Nibble
+    void generate(TableEncoding e, uint8_t* cornerStorage, uint8_t* lowStorage, uint8_t* highStorage)
+    {
+        TaskScheduler* scheduler = &TaskScheduler::instance();
+        if (e == TableEncoding::Mod3) {
+            const OptimalTables& source = get(TableEncoding::Nibble);
+            corners.pack(source.corners, e, cornerStorage);
+            edgesLow.pack(source.edgesLow, e, lowStorage);
+            edgesHigh.pack(source.edgesHigh, e, highStorage);
+            return;
+        }
+        auto expandC = [this](uint32_t i, uint32_t* o) { return expandCorners(i, o); };
+        auto expandE = [this](uint32_t i, uint32_t* o) { return expandEdges(i, o); };
+        corners.build(NUM_CORNER_PDB, cornerIndex(0, 0), expandC, e, scheduler, cornerStorage);
+        edgesLow.build(NUM_EDGE_PDB, edgeIndex(solvedTriple[0], solvedTriple[1]), expandE, e, scheduler, lowStorage);
+        edgesHigh.build(NUM_EDGE_PDB, edgeIndex(solvedTriple[2], solvedTriple[3]), expandE, e, scheduler, highStorage);
+    }
+
+    MappedTableFile m_file;
+    const MoveTable<NUM_CORNER_PERM>* m_cornerMove;
+    const CornerSymmetry* m_cornerSym;
+
+    void buildTripleTables()
+    {
+        // Destino de la arista en la posicion p y cambio de orientacion, por giro
+        int dest[NUM_MOVES][NUM_EDGES] = {}, flip[NUM_MOVES][NUM_EDGES] = {};
+        for (int m = 0; m < NUM_MOVES; ++m)
+            for (int i = 0; i < NUM_EDGES; ++i) {
+                dest[m][MOVE_CUBES[m].ep[i]] = i;
+                flip[m][MOVE_CUBES[m].ep[i]] = MOVE_CUBES[m].eo[i];
+            }
+
+        int setOfMask[1 << NUM_EDGES] = {};
+        int sets = 0;
+        for (int mask = 0; mask < (1 << NUM_EDGES); ++mask)
+            if (std::bitset<NUM_EDGES>(mask).count() == 3) setOfMask[mask] = sets++;
+
+        for (int t = 0; t < NUM_TRIPLE; ++t) {
+            int pos[3], ori[3];
+            decodeTriple(t, pos, ori);
+            tripleSet[t] = (uint8_t)setOfMask[(1 << pos[0]) | (1 << pos[1]) | (1 << pos[2])];
+            for (int m = 0; m < NUM_MOVES; ++m) {
+                int np[3], no[3];
+                for (int k = 0; k < 3; ++k) {
+                    np[k] = dest[m][pos[k]];
+                    no[k] = ori[k] ^ flip[m][pos[k]];
+                }
+                tripleMove.next[t][m] = (uint16_t)encodeTriple(np, no);
+            }
+        }
+
+        // rel: el 2º trio numerado dentro de las 9 posiciones que deja libres el 1º
+        for (int mask = 0; mask < (1 << NUM_EDGES); ++mask) {
+            if (std::bitset<NUM_EDGES>(mask).count() != 3) continue;
+            const int s = setOfMask[mask];
+            for (int b = 0; b < NUM_TRIPLE; ++b) {
+                int pos[3], ori[3];
+                decodeTriple(b, pos, ori);
+                if (mask & ((1 << pos[0]) | (1 << pos[1]) | (1 << pos[2]))) {
+                    rel[s][b] = 0xFFFF;
+                    continue;
+                }
+                int q[3];
+                for (int k = 0; k < 3; ++k) q[k] = pos[k] - (int)std::bitset<NUM_EDGES>(mask & ((1 << pos[k]) - 1)).count();
+                const int q1 = q[1] - (q[1] > q[0]);
+                const int q2 = q[2] - (q[2] > q[0]) - (q[2] > q[1]);
+                const int r = ((q[0] * 8 + q1) * 7 + q2) * 8 + ori[0] * 4 + ori[1] * 2 + ori[2];
+                rel[s][b] = (uint16_t)r;
+                unrel[s][r] = (uint16_t)b;
+            }
+        }
+    }
+};
+
+class OptimalSolver
+{
+public:
+    static constexpr int MAX_DEPTH = 26;
+    static constexpr int SPLIT_DEPTH = 3;   // en paralelo, cada prefijo de 3 giros es una tarea
+
+    struct Result
+    {
+        bool found = false;
+        std::vector<int> moves;
+        double ms = 0.0;
+        long nodes = 0;
+        std::vector<long> nodesPerDepth;   // nodos de cada iteracion de IDA* (indice = cota)
+    };
+
+    // Con `scheduler`, cada iteracion reparte los prefijos del arbol como tareas de prioridad
+    // `priority`; sin el, todo va en el hilo que llama. La solucion es la misma que con un
+    // hilo (la primera en el orden de la busqueda).
+    explicit OptimalSolver(TableEncoding e = TableEncoding::Byte, TaskScheduler* scheduler = nullptr,
+                           TaskPriority priority = TaskPriority::Interactive)
+        : m_tables(OptimalTables::get(e)), m_scheduler(scheduler && scheduler->size() > 1 ? scheduler : nullptr),
+          m_priority(priority)
+    {
+    }
+
+    int threads() const { return m_scheduler ? m_scheduler->size() : 1; }
+
+    Result solve(const CubieCube& cube)
+    {
+        Result result;
+        auto t0 = std::chrono::steady_clock::now();
+        if (!cube.isValid()) return result;
+
+        Node root;
+        root.cornerPerm = getCornerPerm(cube);
+        root.twist = getTwist(cube);
+        for (int g = 0; g < 4; ++g) root.edges[g] = getTriple(cube, g * 3);
+        m_tables.exactDepths(m_tables.cornerIndex(root.cornerPerm, root.twist),
+                             m_tables.edgeIndex(root.edges[0], root.edges[1]),
+                             m_tables.edgeIndex(root.edges[2], root.edges[3]), root.dist);
+
+        int bound = root.dist[0];
+        if (root.dist[1] > bound) bound = root.dist[1];
+        if (root.dist[2] > bound) bound = root.dist[2];
+        for (; bound <= MAX_DEPTH; ++bound) {
+            long nodes = 0;
+            bool found = false;
+            switch (m_tables.encoding) {
+            case TableEncoding::Byte: found = iterate<TableEncoding::Byte>(root, bound, result.moves, nodes); break;
+            case TableEncoding::Nibble: found = iterate<TableEncoding::Nibble>(root, bound, result.moves, nodes); break;
+            case TableEncoding::Mod3: found = iterate<TableEncoding::Mod3>(root, bound, result.moves, nodes); break;
+            }
+            result.nodes += nodes;
+            result.nodesPerDepth.resize(bound + 1, 0);
+            result.nodesPerDepth[bound] = nodes;
+            if (found) {
+                result.found = true;
+                break;
+            }
+        }
+        result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        return result;
+    }
+
+private:
+    struct Node
+    {
+        int cornerPerm;
+        int twist;
+        int edges[4];   // coordenadas de trio de los grupos 0..3
+        int dist[3];    // distancia en cada base de patrones (Mod3 la necesita para los hijos)
+    };
+
+    // Estado de una busqueda en profundidad (una por tarea cuando se reparte)
+    struct Search
+    {
+        int path[MAX_DEPTH];
+        long nodes = 0;
+        size_t task = 0;
+        const std::atomic<size_t>* firstFound = nullptr;   // tarea mas baja que ya tiene solucion
+    };
+
+    struct Task
+    {
+        Node node;
+        int path[SPLIT_DEPTH];
+        int lastFace;
+    };
+
+    const OptimalTables& m_tables;
+    TaskScheduler* m_scheduler;
+    TaskPriority m_priority;
+
+    // Una iteracion de IDA* con cota `bound`
+    template <TableEncoding E>
+    bool iterate(const Node& root, int bound, std::vector<int>& moves, long& nodes)
+    {
+        if (!m_scheduler || bound <= SPLIT_DEPTH) {
+            Search s;
+            const bool found = search<E>(s, root, 0, bound, -1);
+            nodes = s.nodes;
+            if (found) moves.assign(s.path, s.path + bound);
+            return found;
+        }
+
+        // Prefijos que pasan la poda, en el mismo orden en que los visitaria un hilo
+        std::vector<Task> tasks;
+        Search prefix;
+        collectTasks<E>(prefix, root, 0, bound, -1, tasks);
+
+        // Una tarea se abandona en cuanto otra anterior encuentra solucion; las anteriores
+        // siguen, porque la suya iria antes en el orden secuencial
+        std::atomic<size_t> firstFound(SIZE_MAX);
+        std::atomic<long> taskNodes(0);
+        std::vector<std::vector<int>> solutions(tasks.size());
+        m_scheduler->parallelFor(tasks.size(), m_priority, [&](size_t index, int) {
+            const Task& task = tasks[index];
+            Search s;
+            s.task = index;
+            s.firstFound = &firstFound;
+            std::copy(task.path, task.path + SPLIT_DEPTH, s.path);
+            if (firstFound.load(std::memory_order_relaxed) > index &&
+                search<E>(s, task.node, SPLIT_DEPTH, bound - SPLIT_DEPTH, task.lastFace)) {
+                solutions[index].assign(s.path, s.path + bound);
+                size_t seen = firstFound.load();
+                while (index < seen && !firstFound.compare_exchange_weak(seen, index)) {}
+            }
+            taskNodes.fetch_add(s.nodes, std::memory_order_relaxed);
+        });
+
+        nodes = prefix.nodes + taskNodes.load();
+        const size_t first = firstFound.load();
+        if (first == SIZE_MAX) return false;
+        moves = solutions[first];
+        return true;
+    }
+
+    // Hijo de `node` por el giro m; false si se poda (alguna tabla >= togo)
+    template <TableEncoding E>
+    bool child(const Node& node, int m, int togo, Node& next) const
+    {
+        const MoveTable<NUM_CORNER_PERM>& cornerMove = cornerPermMove();
+        next.cornerPerm = cornerMove[node.cornerPerm][m];
+        next.twist = TWIST_MOVE[node.twist][m];
+        next.dist[0] = m_tables.corners.depthFrom<E>(m_tables.cornerIndex(next.cornerPerm, next.twist), node.dist[0]);
+        if (next.dist[0] >= togo) return false;
+        next.edges[0] = m_tables.tripleMove[node.edges[0]][m];
+        next.edges[1] = m_tables.tripleMove[node.edges[1]][m];
+        next.dist[1] = m_tables.edgesLow.depthFrom<E>(m_tables.edgeIndex(next.edges[0], next.edges[1]), node.dist[1]);
+        if (next.dist[1] >= togo) return false;
+        next.edges[2] = m_tables.tripleMove[node.edges[2]][m];
+        next.edges[3] = m_tables.tripleMove[node.edges[3]][m];
+        next.dist[2] = m_tables.edgesHigh.depthFrom<E>(m_tables.edgeIndex(next.edges[2], next.edges[3]), node.dist[2]);
+        return next.dist[2] < togo;
+    }
+
+    static bool skipAfter(int lastFace, int face) { return lastFace >= 0 && (face == lastFace || face + 3 == lastFace); }
+
+    template <TableEncoding E>
+    void collectTasks(Search& s, const Node& node, int depth, int togo, int lastFace, std::vector<Task>& tasks) const
+    {
+        s.nodes++;
+        if (depth == SPLIT_DEPTH) {
+            Task task;
+            task.node = node;
+            std::copy(s.path, s.path + SPLIT_DEPTH, task.path);
+            task.lastFace = lastFace;
+            tasks.push_back(task);
+            s.nodes--;   // el nodo se cuenta en su tarea
+            return;
+        }
+        for (int m = 0; m < NUM_MOVES; ++m) {
+            Node next;
+            if (skipAfter(lastFace, m / 3) || !child<E>(node, m, togo, next)) continue;
+            s.path[depth] = m;
+            collectTasks<E>(s, next, depth + 1, togo - 1, m / 3, tasks);
+        }
+    }
+
+    template <TableEncoding E>
+    bool search(Search& s, const Node& node, int depth, int togo, int lastFace) const
+    {
+        s.nodes++;
+        if (togo == 0) return node.cornerPerm == 0 && node.twist == 0 &&
+                              node.edges[0] == m_tables.solvedTriple[0] && node.edges[1] == m_tables.solvedTriple[1] &&
+                              node.edges[2] == m_tables.solvedTriple[2] && node.edges[3] == m_tables.solvedTriple[3];
+        if (s.firstFound && s.firstFound->load(std::memory_order_relaxed) < s.task) return false;
+
+        for (int m = 0; m < NUM_MOVES; ++m) {
+            // Se poda con cada tabla en cuanto supera lo que queda
+            Node next;
+            if (skipAfter(lastFace, m / 3) || !child<E>(node, m, togo, next)) continue;
+            s.path[depth] = m;
+            if (search<E>(s, next, depth + 1, togo - 1, m / 3)) return true;
+        }
+        return false;
+    }
+};
+
+#endif
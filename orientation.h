@@ -0,0 +1,160 @@
+#ifndef ORIENTATION_H
+#define ORIENTATION_H
+
+#include <array>
+#include <cstdint>
+
+//-----------------------------grupo de rotaciones del cubo-----------------------------
+// Las 24 orientaciones de un cubie (o del cubo entero) son las matrices 3x3 de enteros con
+// un solo +-1 por fila y columna y determinante +1. Se generan en tiempo de compilacion
+// cerrando los cuartos de vuelta sobre X, Y y Z; el indice 0 es la identidad.
+//
+//   ROTATIONS[r]               matriz de la rotacion (enteros: nada de trigonometria)
+//   ROTATION_FACE[r][f]        cara a la que va la cara f (orden de Face: U D L R F B)
+//   ROTATION_SLOT[r][s]        hueco al que va el cubie del hueco s = x + 3y + 9z
+//   TURN_ROTATION[eje][q]      q cuartos de vuelta de +90 grados (mano derecha) sobre +eje
+//
+// makeLayerCycles (cubeState.h) saca de ROTATION_SLOT y ROTATION_FACE de TURN_ROTATION a
+// donde va cada sticker en un giro de capa.
+
+const int NUM_ROTATIONS = 24;
+
+struct Rotation
+{
+    int8_t m[3][3];
+
+    constexpr Rotation operator*(const Rotation& b) const
+    {
+        Rotation r{};
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j) {
+                int sum = 0;
+                for (int k = 0; k < 3; ++k) sum += m[i][k] * b.m[k][j];
+                r.m[i][j] = (int8_t)sum;
+            }
+        return r;
+    }
+
+    constexpr bool operator==(const Rotation& b) const
+    {
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                if (m[i][j] != b.m[i][j]) return false;
+        return true;
+    }
+
+    // Vector entero (posiciones centradas en el cubo, normales de cara)
+    constexpr void apply(const int in[3], int out[3]) const
+    {
+        for (int i = 0; i < 3; ++i) out[i] = m[i][0] * in[0] + m[i][1] * in[1] + m[i][2] * in[2];
+    }
+};
+
+// Normal exterior de cada cara, en el orden de Face
+constexpr int FACE_NORMAL[6][3] = { {0, 1, 0}, {0, -1, 0}, {-1, 0, 0}, {1, 0, 0}, {0, 0, 1}, {0, 0, -1} };
+
+// +90 grados sobre +axis: con u, v los otros dos ejes, u' = -v y v' = u
+constexpr Rotation quarterTurn(int axis)
+{
+    Rotation r{};
+    const int u = (axis + 1) % 3, v = (axis + 2) % 3;
+    r.m[axis][axis] = 1;
+    r.m[u][v] = -1;
+    r.m[v][u] = 1;
+    return r;
+}
+
+constexpr std::array<Rotation, NUM_ROTATIONS> makeRotations()
+{
+    std::array<Rotation, NUM_ROTATIONS> rotations{};
+    for (int i = 0; i < 3; ++i) rotations[0].m[i][i] = 1;
+    int count = 1;
+    for (int i = 0; i < count; ++i)
+        for (int axis = 0; axis < 3; ++axis) {
+            const Rotation r = quarterTurn(axis) * rotations[i];
+            bool known = false;
+            for (int j = 0; j < count; ++j) known = known || rotations[j] == r;
+            if (!known && count < NUM_ROTATIONS) rotations[count++] = r;
+        }
+    return rotations;
+}
+
+inline constexpr std::array<Rotation, NUM_ROTATIONS> ROTATIONS = makeRotations();
+
+constexpr int findRotation(const Rotation& r)
+{
+    for (int i = 0; i < NUM_ROTATIONS; ++i)
+        if (ROTATIONS[i] == r) return i;
+    return -1;
+}
+
+// Solo para construir y comprobar las tablas de abajo
+constexpr int composeRotation(int a, int b) { return findRotation(ROTATIONS[a] * ROTATIONS[b]); }
+
+constexpr int inverseRotation(int a)
+{
+    for (int b = 0; b < NUM_ROTATIONS; ++b)
+        if (composeRotation(a, b) == 0) return b;
+    return -1;
+}
+
+constexpr std::array<std::array<uint8_t, 6>, NUM_ROTATIONS> makeRotationFace()
+{
+    std::array<std::array<uint8_t, 6>, NUM_ROTATIONS> table{};
+    for (int r = 0; r < NUM_ROTATIONS; ++r)
+        for (int f = 0; f < 6; ++f) {
+            int n[3] = {};
+            ROTATIONS[r].apply(FACE_NORMAL[f], n);
+            for (int g = 0; g < 6; ++g)
+                if (FACE_NORMAL[g][0] == n[0] && FACE_NORMAL[g][1] == n[1] && FACE_NORMAL[g][2] == n[2])
+                    table[r][f] = (uint8_t)g;
+        }
+    return table;
+}
+
+inline constexpr std::array<std::array<uint8_t, 6>, NUM_ROTATIONS> ROTATION_FACE = makeRotationFace();
+
+constexpr std::array<std::array<uint8_t, 27>, NUM_ROTATIONS> makeRotationSlot()
+{
+    std::array<std::array<uint8_t, 27>, NUM_ROTATIONS> table{};
+    for (int r = 0; r < NUM_ROTATIONS; ++r)
+        for (int s = 0; s < 27; ++s) {
+            const int p[3] = { s % 3 - 1, s / 3 % 3 - 1, s / 9 - 1 };
+            int q[3] = {};
+            ROTATIONS[r].apply(p, q);
+            table[r][s] = (uint8_t)((q[0] + 1) + (q[1] + 1) * 3 + (q[2] + 1) * 9);
+        }
+    return table;
+}
+
+inline constexpr std::array<std::array<uint8_t, 27>, NUM_ROTATIONS> ROTATION_SLOT = makeRotationSlot();
+
+constexpr std::array<std::array<uint8_t, 4>, 3> makeTurnRotation()
+{
+    std::array<std::array<uint8_t, 4>, 3> table{};
+    for (int axis = 0; axis < 3; ++axis) {
+        const int quarter = findRotation(quarterTurn(axis));
+        for (int q = 1; q < 4; ++q) table[axis][q] = (uint8_t)composeRotation(quarter, table[axis][q - 1]);
+    }
+    return table;
+}
+
+inline constexpr std::array<std::array<uint8_t, 4>, 3> TURN_ROTATION = makeTurnRotation();
+
+constexpr bool checkRotationGroup()
+{
+    for (int a = 0; a < NUM_ROTATIONS; ++a) {
+        if (findRotation(ROTATIONS[a]) != a) return false;      // las 24 son distintas
+        if (composeRotation(a, inverseRotation(a)) != 0 || composeRotation(inverseRotation(a), a) != 0) return false;
+        if (ROTATION_SLOT[a][13] != 13) return false;           // el centro no se mueve
+    }
+    for (int axis = 0; axis < 3; ++axis)
+        if (composeRotation(TURN_ROTATION[axis][1], TURN_ROTATION[axis][3]) != 0) return false;
+    return true;
+}
+
+static_assert(checkRotationGroup(), "el grupo de rotaciones no esta bien construido");
+// +90 sobre +X lleva U a F (con la mano derecha)
+static_assert(ROTATION_FACE[TURN_ROTATION[0][1]][0] == 4, "sentido de giro inesperado");
+
+#endif
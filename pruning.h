@@ -0,0 +1,419 @@
+#ifndef PRUNING_H
+#define PRUNING_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+
+#include "coordCube.h"
+#include "tableFile.h"
+#include "threadPool.h"
+
+//--------------------------almacenamiento de las tablas--------------------------------
+// Una tabla de distancias vive en memoria propia (recien generada) o dentro de un
+// MappedTableFile (solo lectura, sin copia). Junto a los datos se guarda cuantas
+// entradas hay a cada distancia, en la seccion "<nombre>.capas".
+
+template <typename T>
+class DepthTable
+{
+public:
+    static const int MAX_LAYERS = 32;
+
+    int maxDepth() const { return (int)m_layerCounts.size() - 1; }
+    size_t size() const { return m_size; }
+    const std::vector<uint64_t>& layerCounts() const { return m_layerCounts; }   // entradas por distancia
+
+    static const size_t LAYERS_BYTES = MAX_LAYERS * sizeof(uint64_t);
+
+    void save(TableFileWriter& writer, const std::string& name) const
+    {
+        m_savedLayers.resize(MAX_LAYERS);
+        storeLayers(m_savedLayers.data());
+        writer.add(name.c_str(), m_depth, m_size * sizeof(T));
+        writer.add((name + ".capas").c_str(), m_savedLayers.data(), LAYERS_BYTES);
+    }
+
+    // Escribe la seccion "<nombre>.capas" (LAYERS_BYTES) en `out`
+    void storeLayers(void* out) const
+    {
+        uint64_t layers[MAX_LAYERS] = {};
+        std::copy(m_layerCounts.begin(), m_layerCounts.end(), layers);
+        std::memcpy(out, layers, LAYERS_BYTES);
+    }
+
+    // Usa la seccion `name` del fichero; falla si no esta o no tiene `size` entradas
+    bool attach(const MappedTableFile& file, const std::string& name, size_t size)
+    {
+        const void* data = file.section(name.c_str(), size * sizeof(T));
+        const uint64_t* layers = (const uint64_t*)file.section((name + ".capas").c_str(), LAYERS_BYTES);
+        if (!data || !layers) return false;
+        m_owned.clear();
+        m_owned.shrink_to_fit();
+        m_depth = (const T*)data;
+        m_size = size;
+        m_layerCounts.clear();
+        for (int d = 0; d < MAX_LAYERS && layers[d] != 0; ++d) m_layerCounts.push_back(layers[d]);
+        return true;
+    }
+
+protected:
+    const T* m_depth = nullptr;
+    size_t m_size = 0;
+    std::vector<T> m_owned;
+    std::vector<uint64_t> m_layerCounts;
+    mutable std::vector<uint64_t> m_savedLayers;
+
+    // Prepara `size` elementos a `fill` para generar la tabla: en `storage` (p. ej. una
+    // seccion de TableFileBuilder) o, si es nullptr, en memoria propia
+    T* allocate(size_t size, T fill, T* storage = nullptr)
+    {
+        if (storage) {
+            m_owned.clear();
+            m_owned.shrink_to_fit();
+            std::fill(storage, storage + size, fill);
+        } else {
+            m_owned.assign(size, fill);
+            storage = m_owned.data();
+        }
+        m_depth = storage;
+        m_size = size;
+        m_layerCounts.clear();
+        return storage;
+    }
+};
+
+//--------------------------------tablas de poda----------------------------------------
+// Distancia exacta (en giros) al objetivo para cada par de coordenadas (a, b), calculada
+// con una BFS hacia atras desde el objetivo. Sirve de heuristica admisible para IDA*:
+// nunca sobreestima, porque ignora el resto de coordenadas.
+
+class PruningTable : public DepthTable<int8_t>
+{
+public:
+    static constexpr int8_t UNKNOWN = -1;
+
+    PruningTable() : m_sizeB(0) {}
+
+    // sizeA/sizeB = valores usados de cada coordenada (pueden ser menos que las filas de
+    // la tabla de giros, p. ej. sliceSorted < 24 dentro de G1)
+    // moves = giros permitidos (indices 0..17); goal = (a, b) del objetivo
+    template <int NA, int NB>
+    void build(const MoveTable<NA>& moveA, int sizeA, const MoveTable<NB>& moveB, int sizeB,
+               const std::vector<int>& moves, int goalA, int goalB)
+    {
+        const uint32_t NB_USED = (uint32_t)sizeB;
+        m_sizeB = sizeB;
+        int8_t* table = allocate((size_t)sizeA * sizeB, UNKNOWN);
+
+        std::vector<uint32_t> frontier, next;
+        const uint32_t goal = (uint32_t)goalA * NB_USED + goalB;
+        table[goal] = 0;
+        frontier.push_back(goal);
+
+        int depth = 0;
+        while (!frontier.empty()) {
+            m_layerCounts.push_back(frontier.size());
+            next.clear();
+            for (uint32_t index : frontier) {
+                const int a = (int)(index / NB_USED), b = (int)(index % NB_USED);
+                for (int m : moves) {
+                    const uint32_t n = (uint32_t)moveA[a][m] * NB_USED + moveB[b][m];
+                    if (table[n] != UNKNOWN) continue;
+                    table[n] = (int8_t)(depth + 1);
+                    next.push_back(n);
+                }
+            }
+            frontier.swap(next);
+            depth++;
+        }
+    }
+
+    bool attach(const MappedTableFile& file, const std::string& name, int sizeA, int sizeB)
+    {
+        if (!DepthTable::attach(file, name, (size_t)sizeA * sizeB)) return false;
+        m_sizeB = sizeB;
+        return true;
+    }
+
+    int depth(int a, int b) const { return m_depth[(size_t)a * m_sizeB + b]; }
+
+private:
+    int m_sizeB;
+};
+
+//--------------------------------bases de patrones-------------------------------------
+// Igual que PruningTable pero para espacios grandes (decenas de millones de entradas):
+// la BFS recorre la tabla por capas en vez de guardar la frontera, repartida entre hilos.
+// Mientras la capa crece se expande hacia delante; cuando ya se conoce mas de la mitad de
+// la tabla conviene ir hacia atras (cada entrada desconocida busca un vecino en la capa actual).
+// `expand(index, out)` escribe los vecinos de index en out[] y devuelve cuantos son.
+//
+// Codificaciones (se eligen al generar la tabla; memoria frente a nodos por segundo):
+//   Byte    1 byte por entrada
+//   Nibble  4 bits por entrada (dos por byte)
+//   Mod3    2 bits: solo la distancia modulo 3. Un giro cambia la distancia en -1, 0 o +1,
+//           asi que conocida la del padre la del hijo se recupera sin ambiguedad.
+//           La de la raiz se obtiene bajando por vecinos hasta el objetivo (exactDepth).
+
+enum class TableEncoding { Byte, Nibble, Mod3 };
+
+inline const char* tableEncodingName(TableEncoding e)
+{
+    return e == TableEncoding::Byte ? "byte" : e == TableEncoding::Nibble ? "nibble" : "mod3";
+}
+
+// Diferencia de distancia hijo - padre segun (mod3 hijo - mod3 padre + 2)
+const int8_t MOD3_STEP[5] = { 1, -1, 0, 1, -1 };
+
+class PatternDatabase : public DepthTable<uint8_t>
+{
+public:
+    static constexpr uint8_t UNKNOWN = 0xFF;
+    static const int MAX_NEIGHBORS = NUM_MOVES;
+
+    PatternDatabase() : m_entries(0), m_encoding(TableEncoding::Byte) {}
+
+    static size_t storageBytes(TableEncoding e, size_t entries)
+    {
+        return e == TableEncoding::Byte ? entries : e == TableEncoding::Nibble ? (entries + 1) / 2 : (entries + 3) / 4;
+    }
+
+    // Tiempo y estados nuevos de cada capa de la ultima generacion
+    struct LayerStats
+    {
+        int depth;
+        uint64_t states;
+        double ms;
+        bool backward;
+    };
+
+    // Genera la tabla en Byte o Nibble (Mod3 se obtiene con pack) como tareas de fondo de
+    // `scheduler` (nullptr = en el hilo que llama), en `storage` si se da (ver DepthTable::allocate)
+    template <typename Expand>
+    void build(size_t size, uint32_t goal, Expand expand, TableEncoding e = TableEncoding::Byte,
+               TaskScheduler* scheduler = nullptr, uint8_t* storage = nullptr)
+    {
+        if (e == TableEncoding::Nibble) buildLayers<TableEncoding::Nibble>(size, goal, expand, scheduler, storage);
+        else buildLayers<TableEncoding::Byte>(size, goal, expand, scheduler, storage);
+    }
+
+    // Copia comprimida de una tabla Byte o Nibble ya generada
+    void pack(const PatternDatabase& source, TableEncoding e, uint8_t* storage = nullptr)
+    {
+        const size_t n = source.m_entries;
+        uint8_t* out = allocate(storageBytes(e, n), 0, storage);
+        m_entries = n;
+        m_encoding = e;
+        m_layerCounts = source.m_layerCounts;
+        m_buildStats.clear();
+        const int unknown = source.m_encoding == TableEncoding::Nibble ? 15 : UNKNOWN;
+        for (size_t i = 0; i < n; ++i) {
+            const int d = source.m_encoding == TableEncoding::Nibble ? source.depthFrom<TableEncoding::Nibble>(i, 0)
+                                                                     : source.m_depth[i];
+            if (e == TableEncoding::Byte) out[i] = (uint8_t)(d == unknown ? UNKNOWN : d);
+            else if (e == TableEncoding::Nibble) out[i >> 1] |= (uint8_t)((d & 15) << ((i & 1) << 2));
+            else out[i >> 2] |= (uint8_t)((d == unknown ? 3 : d % 3) << ((i & 3) << 1));
+        }
+    }
+
+    bool attach(const MappedTableFile& file, const std::string& name, size_t entries, TableEncoding e)
+    {
+        if (!DepthTable::attach(file, name, storageBytes(e, entries))) return false;
+        m_entries = entries;
+        m_encoding = e;
+        return true;
+    }
+
+    // Distancia de la entrada i sabiendo la del padre (solo la usa Mod3). Sin saltos:
+    // el bucle de busqueda se instancia para una codificacion concreta.
+    template <TableEncoding E>
+    int depthFrom(size_t i, int parentDepth) const
+    {
+        if constexpr (E == TableEncoding::Byte) {
+            return m_depth[i];
+        } else if constexpr (E == TableEncoding::Nibble) {
+            return (m_depth[i >> 1] >> ((i & 1) << 2)) & 15;
+        } else {
+            const int r = (m_depth[i >> 2] >> ((i & 3) << 1)) & 3;
+            return parentDepth + MOD3_STEP[r - parentDepth % 3 + 2];
+        }
+    }
+
+    // Distancia exacta sin conocer la del padre; con Mod3 baja por vecinos hasta `goal`
+    template <typename Expand>
+    int exactDepth(uint32_t index, uint32_t goal, Expand expand) const
+    {
+        if (m_encoding == TableEncoding::Byte) return depthFrom<TableEncoding::Byte>(index, 0);
+        if (m_encoding == TableEncoding::Nibble) return depthFrom<TableEncoding::Nibble>(index, 0);
+
+        uint32_t neighbors[MAX_NEIGHBORS];
+        int depth = 0;
+        while (index != goal && depth < MAX_LAYERS) {
+            const int closer = (mod3(index) + 2) % 3;
+            const int n = expand(index, neighbors);
+            for (int k = 0; k < n; ++k)
+                if (mod3(neighbors[k]) == closer) {
+                    index = neighbors[k];
+                    break;
+                }
+            depth++;
+        }
+        return depth;
+    }
+
+    size_t size() const { return m_entries; }
+    size_t bytes() const { return DepthTable::size(); }
+    TableEncoding encoding() const { return m_encoding; }
+
+    const std::vector<LayerStats>& buildStats() const { return m_buildStats; }
+
+private:
+    size_t m_entries;
+    TableEncoding m_encoding;
+    std::vector<LayerStats> m_buildStats;
+
+    static const size_t CHUNK = 1 << 16;   // entradas por reparto (par: un byte Nibble nunca se comparte)
+
+    int mod3(size_t i) const { return (m_depth[i >> 2] >> ((i & 3) << 1)) & 3; }
+
+    // Acceso concurrente a la tabla mientras se genera. Las lecturas son relajadas: lo unico
+    // que cambia durante una capa es UNKNOWN -> siguiente, que nunca se confunde con la actual.
+    template <TableEncoding E>
+    static int load(const std::atomic<uint8_t>* t, size_t i)
+    {
+        if constexpr (E == TableEncoding::Byte) return t[i].load(std::memory_order_relaxed);
+        else return (t[i >> 1].load(std::memory_order_relaxed) >> ((i & 1) << 2)) & 15;
+    }
+
+    // Escribe `value` si la entrada sigue desconocida; true si la ha escrito este hilo.
+    // Shared = false cuando nadie mas puede escribir ese byte (un solo hilo, o la propia
+    // entrada en la pasada hacia atras): basta leer y escribir, sin instruccion atomica.
+    template <TableEncoding E, bool Shared>
+    static bool claim(std::atomic<uint8_t>* t, size_t i, uint8_t value)
+    {
+        if constexpr (!Shared) {
+            if (load<E>(t, i) != (E == TableEncoding::Byte ? UNKNOWN : 15)) return false;
+            if constexpr (E == TableEncoding::Byte) {
+                t[i].store(value, std::memory_order_relaxed);
+            } else {
+                const int shift = (int)(i & 1) << 2;
+                const uint8_t old = t[i >> 1].load(std::memory_order_relaxed);
+                t[i >> 1].store((uint8_t)((old & ~(15 << shift)) | (value << shift)), std::memory_order_relaxed);
+            }
+            return true;
+        } else if constexpr (E == TableEncoding::Byte) {
+            uint8_t expected = UNKNOWN;
+            return t[i].compare_exchange_strong(expected, value, std::memory_order_relaxed);
+        } else {
+            const int shift = (int)(i & 1) << 2;
+            std::atomic<uint8_t>& byte = t[i >> 1];
+            uint8_t old = byte.load(std::memory_order_relaxed);
+            do {
+                if (((old >> shift) & 15) != 15) return false;
+            } while (!byte.compare_exchange_weak(old, (uint8_t)((old & ~(15 << shift)) | (value << shift)),
+                                                 std::memory_order_relaxed));
+            return true;
+        }
+    }
+
+    static void markDepth(std::atomic<uint32_t>* chunkDepths, size_t i, int depth)
+    {
+        std::atomic<uint32_t>& mask = chunkDepths[i / CHUNK];
+        if (!(mask.load(std::memory_order_relaxed) & (1u << depth))) mask.fetch_or(1u << depth, std::memory_order_relaxed);
+    }
+
+    // Una pasada de la capa `depth` sobre [begin, end); devuelve las entradas nuevas
+    template <TableEncoding E, bool Shared, bool Backward, typename Expand>
+    static uint64_t scanChunk(std::atomic<uint8_t>* table, std::atomic<uint32_t>* chunkDepths, size_t begin,
+                              size_t end, int depth, Expand& expand)
+    {
+        const int unknown = E == TableEncoding::Byte ? UNKNOWN : 15;
+        const uint8_t next = (uint8_t)(depth + 1);
+        uint32_t neighbors[MAX_NEIGHBORS];
+        uint64_t found = 0;
+        for (size_t i = begin; i < end; ++i) {
+            if (!Backward) {
+                if (load<E>(table, i) != depth) continue;
+                const int n = expand((uint32_t)i, neighbors);
+                for (int k = 0; k < n; ++k)
+                    if (load<E>(table, neighbors[k]) == unknown && claim<E, Shared>(table, neighbors[k], next)) {
+                        markDepth(chunkDepths, neighbors[k], next);
+                        found++;
+                    }
+            } else {
+                if (load<E>(table, i) != unknown) continue;
+                const int n = expand((uint32_t)i, neighbors);
+                for (int k = 0; k < n; ++k)
+                    if (load<E>(table, neighbors[k]) == depth) {
+                        // Solo este hilo escribe en su bloque durante la pasada hacia atras
+                        claim<E, false>(table, i, next);
+                        markDepth(chunkDepths, i, next);
+                        found++;
+                        break;
+                    }
+            }
+        }
+        return found;
+    }
+
+    // BFS por capas. Cada capa es una tarea por bloque de CHUNK; hacia delante varios hilos
+    // pueden llegar a la misma entrada y claim() deja pasar solo a uno.
+    template <TableEncoding E, typename Expand>
+    void buildLayers(size_t size, uint32_t goal, Expand& expand, TaskScheduler* scheduler, uint8_t* storage)
+    {
+        static_assert(sizeof(std::atomic<uint8_t>) == 1, "la tabla se accede como std::atomic<uint8_t>");
+        const bool shared = scheduler && scheduler->size() > 1;
+
+        uint8_t* bytes = allocate(storageBytes(E, size), 0xFF, storage);
+        std::atomic<uint8_t>* table = reinterpret_cast<std::atomic<uint8_t>*>(bytes);
+        m_entries = size;
+        m_encoding = E;
+        m_buildStats.clear();
+        claim<E, false>(table, goal, 0);
+        m_layerCounts.push_back(1);
+
+        // Bit d de chunkDepths[c] = el bloque c tiene alguna entrada a distancia d. Hacia
+        // delante se saltan los bloques sin la capa actual (casi todos en las primeras capas).
+        const size_t chunks = (size + CHUNK - 1) / CHUNK;
+        std::unique_ptr<std::atomic<uint32_t>[]> chunkDepths(new std::atomic<uint32_t>[chunks]);
+        for (size_t c = 0; c < chunks; ++c) chunkDepths[c].store(0, std::memory_order_relaxed);
+        chunkDepths[goal / CHUNK].store(1);
+
+        size_t known = 1;
+        for (int depth = 0; known < size; ++depth) {
+            auto t0 = std::chrono::steady_clock::now();
+            const bool backward = known >= size / 2;
+            std::atomic<uint64_t> found(0);
+
+            auto scan = [&](size_t chunk, int) {
+                const size_t begin = chunk * CHUNK, end = std::min(size, begin + CHUNK);
+                uint64_t n;
+                if (backward)
+                    n = scanChunk<E, false, true>(table, chunkDepths.get(), begin, end, depth, expand);
+                else if (!(chunkDepths[chunk].load(std::memory_order_relaxed) & (1u << depth)))
+                    return;
+                else if (shared)
+                    n = scanChunk<E, true, false>(table, chunkDepths.get(), begin, end, depth, expand);
+                else
+                    n = scanChunk<E, false, false>(table, chunkDepths.get(), begin, end, depth, expand);
+                if (n) found.fetch_add(n, std::memory_order_relaxed);
+            };
+            if (scheduler) scheduler->parallelFor(chunks, TaskPriority::Background, scan);
+            else for (size_t c = 0; c < chunks; ++c) scan(c, 0);
+
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            m_buildStats.push_back({ depth + 1, found.load(), ms, backward });
+            if (found == 0) break;   // el resto es inalcanzable
+            known += found;
+            m_layerCounts.push_back(found);
+        }
+    }
+};
+
+#endif
@@ -1,50 +1,173 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+
 class Shader {
 public:
     unsigned int ID;
 
+    // Handle tipado a un uniform resuelto al enlazar; slot = -1 si no existe o no está activo
+    template <GLenum TYPE>
+    struct UniformHandle {
+        int slot = -1;
+        bool valid() const { return slot >= 0; }
+    };
+    using Mat4Handle  = UniformHandle<GL_FLOAT_MAT4>;
+    using Vec3Handle  = UniformHandle<GL_FLOAT_VEC3>;
+    using FloatHandle = UniformHandle<GL_FLOAT>;
+    using IVec2Handle = UniformHandle<GL_INT_VEC2>;
+
+    // Subidas de uniforms desde el último resetStats(): emitidas vs omitidas por no cambiar
+    struct UploadStats {
+        unsigned int issued = 0;
+        unsigned int skipped = 0;
+    };
+
     Shader(const char* vertexSource, const char* fragmentSource) {
         unsigned int vertex, fragment;
-        
+
         vertex = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(vertex, 1, &vertexSource, NULL);
         glCompileShader(vertex);
         checkCompileErrors(vertex, "VERTEX");
-        
+
         fragment = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragment, 1, &fragmentSource, NULL);
         glCompileShader(fragment);
         checkCompileErrors(fragment, "FRAGMENT");
-        
+
         ID = glCreateProgram();
         glAttachShader(ID, vertex);
         glAttachShader(ID, fragment);
         glLinkProgram(ID);
         checkCompileErrors(ID, "PROGRAM");
-        
+
         glDeleteShader(vertex);
         glDeleteShader(fragment);
+
+        cacheUniforms();
+    }
+
+    // Evita glUseProgram si el programa ya está en uso
+    void use() {
+        if (s_current != ID) {
+            glUseProgram(ID);
+            s_current = ID;
+        }
     }
 
-    void use() { 
-        glUseProgram(ID); 
+    // Resuelve un uniform por nombre (sin llamadas GL) y comprueba su tipo
+    template <GLenum TYPE>
+    UniformHandle<TYPE> uniform(const std::string &name) const {
+        UniformHandle<TYPE> handle;
+        auto it = m_lookup.find(name);
+        if (it == m_lookup.end()) return handle;
+        if (m_uniforms[it->second].type != TYPE) {
+            std::cout << "ERROR::SHADER::UNIFORM_TYPE_MISMATCH: " << name << std::endl;
+            return handle;
+        }
+        handle.slot = it->second;
+        return handle;
     }
 
-    void setMat4(const std::string &name, const float* mat) const {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, mat);
+    // Los set* asumen que el programa está en uso (use())
+    void setMat4(Mat4Handle u, const float* mat) {
+        if (changed(u.slot, mat, 16 * sizeof(float)))
+            glUniformMatrix4fv(m_uniforms[u.slot].location, 1, GL_FALSE, mat);
     }
 
-    void setVec3Array(const std::string &name, int count, const Vec3 *values) const {
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), count, (const GLfloat*)values);
+    void setVec3Array(Vec3Handle u, int count, const Vec3 *values) {
+        if (changed(u.slot, values, count * sizeof(Vec3)))
+            glUniform3fv(m_uniforms[u.slot].location, count, (const GLfloat*)values);
     }
-	
-	void setFloat(const std::string &name, float value) const { 
-		glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+
+	void setFloat(FloatHandle u, float value) {
+		if (changed(u.slot, &value, sizeof(float)))
+			glUniform1f(m_uniforms[u.slot].location, value);
 	}
 
+	void setIVec2(IVec2Handle u, int x, int y) {
+		const int value[2] = { x, y };
+		if (changed(u.slot, value, sizeof(value)))
+			glUniform2i(m_uniforms[u.slot].location, x, y);
+	}
+
+    // Variantes por nombre: buscan en la caché, nunca llaman a glGetUniformLocation
+    void setMat4(const std::string &name, const float* mat) {
+        setMat4(uniform<GL_FLOAT_MAT4>(name), mat);
+    }
+
+    void setVec3Array(const std::string &name, int count, const Vec3 *values) {
+        setVec3Array(uniform<GL_FLOAT_VEC3>(name), count, values);
+    }
+
+	void setFloat(const std::string &name, float value) {
+		setFloat(uniform<GL_FLOAT>(name), value);
+	}
+
+    // Asocia un bloque uniform (UBO) del programa a un binding point fijo
+    void bindUniformBlock(const char* blockName, GLuint binding) {
+        GLuint index = glGetUniformBlockIndex(ID, blockName);
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(ID, index, binding);
+    }
+
+    const UploadStats& stats() const { return m_stats; }
+    void resetStats() { m_stats = UploadStats(); }
+
 private:
+    struct UniformSlot {
+        GLint location;
+        GLenum type;
+        std::vector<unsigned char> value; // último valor subido (vacío = nunca subido)
+    };
+
+    std::vector<UniformSlot> m_uniforms;
+    std::unordered_map<std::string, int> m_lookup;
+    UploadStats m_stats;
+    inline static unsigned int s_current = 0; // programa actualmente en uso
+
+    // Consulta todos los uniforms activos una sola vez, después de enlazar
+    void cacheUniforms() {
+        GLint count = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        char name[256];
+        for (GLint i = 0; i < count; i++) {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(ID, (GLuint)i, sizeof(name), &length, &size, &type, name);
+
+            std::string key(name, length);
+            // Los arrays se reportan como "u_nombre[0]"
+            if (key.size() > 3 && key.compare(key.size() - 3, 3, "[0]") == 0)
+                key.resize(key.size() - 3);
+
+            GLint location = glGetUniformLocation(ID, name);
+            if (location < 0) continue; // uniforms de bloques (UBO)
+
+            m_lookup[key] = (int)m_uniforms.size();
+            m_uniforms.push_back(UniformSlot{ location, type, {} });
+        }
+    }
+
+    // Actualiza la caché y dice si hay que emitir glUniform*
+    bool changed(int slot, const void* data, size_t bytes) {
+        if (slot < 0) return false;
+        std::vector<unsigned char>& cached = m_uniforms[slot].value;
+        if (cached.size() == bytes && std::memcmp(cached.data(), data, bytes) == 0) {
+            m_stats.skipped++;
+            return false;
+        }
+        cached.assign((const unsigned char*)data, (const unsigned char*)data + bytes);
+        m_stats.issued++;
+        return true;
+    }
+
     void checkCompileErrors(unsigned int shader, std::string type) {
         int success;
         char infoLog[1024];
@@ -65,4 +188,4 @@ private:
     }
 };
 
-#endif 
+#endif
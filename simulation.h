@@ -0,0 +1,257 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "cubeState.h"
+#include "tripleBuffer.h"
+#include "moveQueue.h"
+
+//------------------------------simulacion del cubo-------------------------------------
+// Un hilo propio es el dueno del estado logico: cualquier hilo le manda giros (post) por
+// una MoveQueue sin cerrojos y el los saca por lotes y junta los de la misma capa
+// (coalesceTurn) antes de animarlos o aplicarlos. Cada cambio se publica como una
+// instantanea en un TripleBuffer; el bucle de render la recoge con update() sin
+// bloquearse y siempre dibuja la ultima completa.
+//
+// Con setTurnSeconds(s > 0) los giros se animan de uno en uno: la instantanea lleva el
+// giro en curso y cuando empezo, el render calcula el angulo con su propio reloj y el
+// vertex shader gira la capa; el estado solo cambia (una vez) cuando el giro termina.
+// Cuantos mas giros esperan, mas corto es cada uno (sin bajar de MIN_TURN_SECONDS), y por
+// encima de MAX_ANIMATED los mas antiguos se aplican sin animar, asi una solucion que llega
+// entera de golpe se ve girar y no se queda atras.
+
+// Angulo de una capa a mitad de giro (progress 0..1), en radianes y con el signo del giro:
+// R' va hacia atras en vez de dar tres cuartos de vuelta
+inline float turnAngle(const Turn& t, float progress)
+{
+    const float quarters = t.quarters == 3 ? -1.0f : (float)t.quarters;
+    return quarters * 1.57079633f * std::min(1.0f, std::max(0.0f, progress));
+}
+
+struct CubeSnapshot
+{
+    using Clock = std::chrono::steady_clock;
+
+    CubeState state;            // sin el giro en curso
+    CubeState target;           // como quedara al acabar todo lo pendiente
+    uint64_t processed = 0;     // giros recibidos cuyo efecto ya esta en `state`
+    bool turning = false;
+    Turn turn{};                // giro en curso (si turning)
+    Clock::time_point turnStart;
+    float turnSeconds = 0.0f;
+
+    // Angulo del giro en curso visto en `now` (el render usa su reloj, no el de publicacion)
+    float turnAngle(Clock::time_point now) const
+    {
+        if (!turning) return 0.0f;
+        return ::turnAngle(turn, std::chrono::duration<float>(now - turnStart).count() / turnSeconds);
+    }
+};
+
+class CubeSimulation
+{
+public:
+    static const size_t BATCH = 4096;       // comandos sacados de la cola de una vez
+    static const size_t MAX_ANIMATED = 32;  // giros pendientes que aun se animan
+    static constexpr float MIN_TURN_SECONDS = 0.06f;   // un giro animado se sigue viendo con cola
+
+    struct Stats
+    {
+        uint64_t received = 0;      // giros sacados de la cola
+        uint64_t applied = 0;       // giros aplicados tras juntarlos
+        uint64_t batches = 0;
+        MoveQueue::Stats queue;
+    };
+
+    explicit CubeSimulation(const CubeState& initial = CubeState())
+        : m_snapshots(initialSnapshot(initial)), m_state(initial), m_turnSeconds(0.0f), m_processed(0),
+          m_received(0), m_applied(0), m_batches(0), m_sleeping(false), m_stop(false)
+    {
+        m_thread = std::thread([this] { run(); });
+    }
+
+    ~CubeSimulation()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    CubeSimulation(const CubeSimulation&) = delete;
+    CubeSimulation& operator=(const CubeSimulation&) = delete;
+
+    // --- desde cualquier hilo ---
+    void post(const Turn& t) { push(MoveCommand{ MoveCommand::TURN, t }); }
+
+    void post(const std::vector<Turn>& turns)
+    {
+        for (const Turn& t : turns) post(t);
+    }
+
+    // Duracion de un giro sin cola detras; 0 = sin animacion, todo se aplica al momento.
+    // Vale a partir del siguiente giro que empiece.
+    void setTurnSeconds(float seconds) { m_turnSeconds.store(seconds, std::memory_order_relaxed); }
+
+    // Giros recibidos y ya publicados en `state` (el render puede no haberlos recogido aun)
+    uint64_t processed() const { return m_processed.load(std::memory_order_acquire); }
+
+    Stats stats() const
+    {
+        Stats s;
+        s.received = m_received.load(std::memory_order_relaxed);
+        s.applied = m_applied.load(std::memory_order_relaxed);
+        s.batches = m_batches.load(std::memory_order_relaxed);
+        s.queue = m_queue.stats();
+        return s;
+    }
+
+    // --- solo desde el hilo de render ---
+    bool update() { return m_snapshots.update(); }
+    const CubeSnapshot& snapshot() const { return m_snapshots.front(); }
+
+private:
+    TripleBuffer<CubeSnapshot> m_snapshots;
+    MoveQueue m_queue;
+    // Solo el hilo de simulacion
+    CubeState m_state;
+    std::deque<Turn> m_pending;         // ya juntados, esperando su animacion
+    bool m_turning = false;
+    Turn m_turn{};
+    CubeSnapshot::Clock::time_point m_turnStart, m_turnEnd;
+    float m_turnLength = 0.0f;
+
+    std::atomic<float> m_turnSeconds;
+    std::atomic<uint64_t> m_processed, m_received, m_applied, m_batches;
+    std::atomic<bool> m_sleeping;       // el hilo de simulacion va a dormir o duerme
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stop;
+    std::thread m_thread;
+
+    static CubeSnapshot initialSnapshot(const CubeState& state)
+    {
+        CubeSnapshot s;
+        s.state = s.target = state;
+        return s;
+    }
+
+    void push(const MoveCommand& command)
+    {
+        m_queue.push(command, [this] { wake(); });
+        wake();
+    }
+
+    // El productor publica el comando y luego mira m_sleeping; el consumidor marca
+    // m_sleeping y luego mira la cola (ambos seq_cst): uno de los dos ve al otro
+    void wake()
+    {
+        if (!m_sleeping.load(std::memory_order_seq_cst)) return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake.notify_one();
+    }
+
+    void run()
+    {
+        std::vector<MoveCommand> batch(BATCH);
+        for (;;) {
+            const size_t n = m_queue.popBatch(batch.data(), batch.size());
+            uint64_t received = 0;
+            for (size_t i = 0; i < n; ++i) {
+                if (batch[i].kind != MoveCommand::TURN) continue;
+                // Solo con lo pendiente: el giro que ya se esta animando no se toca
+                coalesceTurn(m_pending, batch[i].turn);
+                received++;
+            }
+            if (n > 0) {
+                m_received.fetch_add(received, std::memory_order_relaxed);
+                m_batches.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            const bool changed = advance(CubeSnapshot::Clock::now());
+            if (n > 0 || changed) publish();
+            if (n == BATCH) continue;   // puede quedar mas en la cola
+
+            m_sleeping.store(true, std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                auto ready = [this] { return m_stop || !m_queue.empty(); };
+                if (m_turning) m_wake.wait_until(lock, m_turnEnd, ready);
+                else m_wake.wait(lock, ready);
+                if (m_stop) return;
+            }
+            m_sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    void commit(const Turn& t)
+    {
+        m_state.turn(t);
+        m_applied.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Termina el giro en curso si le toca, aplica lo que sobra y empieza el siguiente
+    bool advance(CubeSnapshot::Clock::time_point now)
+    {
+        bool changed = false;
+        const float seconds = m_turnSeconds.load(std::memory_order_relaxed);
+        const size_t keep = seconds > 0.0f ? MAX_ANIMATED : 0;
+        // Si sobra cola, el giro en curso se corta: va antes que los que se aplican de golpe
+        if (m_turning && (now >= m_turnEnd || m_pending.size() > keep)) {
+            commit(m_turn);
+            m_turning = false;
+            changed = true;
+        }
+        while (m_pending.size() > keep) {
+            commit(m_pending.front());
+            m_pending.pop_front();
+            changed = true;
+        }
+        if (!m_turning && !m_pending.empty()) {
+            // Con cola, cada giro dura menos: la animacion alcanza a lo que se va pidiendo
+            m_turn = m_pending.front();
+            m_pending.pop_front();
+            m_turnLength = std::max(seconds / (1.0f + m_pending.size() / 2.0f), std::min(seconds, MIN_TURN_SECONDS));
+            m_turnStart = now;
+            m_turnEnd = now + std::chrono::duration_cast<CubeSnapshot::Clock::duration>(
+                                  std::chrono::duration<float>(m_turnLength));
+            m_turning = true;
+            changed = true;
+        }
+        return changed;
+    }
+
+    void publish()
+    {
+        // Mientras quede algo por aplicar, lo recibido aun no esta todo en m_state
+        const bool idle = !m_turning && m_pending.empty();
+        const uint64_t processed = idle ? m_received.load(std::memory_order_relaxed)
+                                        : m_processed.load(std::memory_order_relaxed);
+
+        CubeSnapshot& out = m_snapshots.back();
+        out.state = m_state;
+        out.target = m_state;
+        if (m_turning) out.target.turn(m_turn);
+        for (const Turn& t : m_pending) out.target.turn(t);
+        out.processed = processed;
+        out.turning = m_turning;
+        out.turn = m_turn;
+        out.turnStart = m_turnStart;
+        out.turnSeconds = m_turnLength;
+        m_snapshots.publish();
+        m_processed.store(processed, std::memory_order_release);
+    }
+};
+
+#endif
@@ -0,0 +1,367 @@
+#ifndef SOLUTIONCACHE_H
+#define SOLUTIONCACHE_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#include "cubieCube.h"
+#include "symmetry.h"
+#include "tableFile.h"
+
+#ifndef _WIN32
+#include <sys/file.h>
+#endif
+
+//-------------------------------cache de soluciones------------------------------------
+// Tabla hash en disco, mapeada en memoria, de estado canonico (ver canonicalize) a la mejor
+// solucion conocida. Un estado y sus variantes simetricas o inversas comparten entrada: se
+// guarda la solucion del representante y al leerla se traduce con solutionFromCanonical.
+//
+// Formato:  cabecera (64 bytes) | huecos de 64 bytes (una linea de cache cada uno)
+// Direccionamiento abierto con sondeo lineal de PROBES huecos; nada se borra, solo se
+// sustituye, asi que un hueco vacio termina la busqueda.
+//
+// Un solo escritor y lectores sin cerrojos: cada hueco lleva un contador (seqlock) que el
+// escritor deja impar mientras lo cambia; el lector copia el hueco y lo da por bueno si el
+// contador era par y no ha cambiado. Entre procesos, el escritor es el que consigue el
+// cerrojo del fichero; los demas lo abren solo para leer. Dentro del proceso, las
+// escrituras de varios hilos se turnan con un mutex.
+
+const char SOLUTION_CACHE_MAGIC[8] = { 'C', 'U', 'B', 'I', 'C', 'C', 'H', '\0' };
+const uint32_t SOLUTION_CACHE_FORMAT = 1;
+const char* const SOLUTION_CACHE_FILE = "cubi_solutions.cache";
+
+struct SolutionCacheHeader
+{
+    char magic[8];
+    uint32_t format;
+    uint32_t endian;
+    uint64_t slotCount;                 // potencia de 2
+    std::atomic<uint64_t> entries;      // huecos ocupados (solo lo cambia el escritor)
+    uint8_t reserved[32];
+};
+
+struct SolutionCacheSlot
+{
+    std::atomic<uint32_t> seq;          // par = estable, impar = el escritor lo esta cambiando
+    std::atomic<uint32_t> info;         // USED | OPTIMAL | flip << 8 | numero de giros
+    std::atomic<uint64_t> key;          // (cp * 3^7 + twist) * 12! + permutacion de aristas
+    std::atomic<uint64_t> moves[6];     // un giro por byte, en el orden de la solucion
+};
+
+static_assert(sizeof(SolutionCacheHeader) == 64 && sizeof(SolutionCacheSlot) == 64, "un hueco por linea de cache");
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "los atomicos del fichero se comparten entre procesos");
+
+class SolutionCache
+{
+public:
+    static const uint64_t DEFAULT_SLOTS = 1 << 18;   // 16 MB
+    static const int PROBES = 8;
+    static const int MAX_MOVES = 48;
+
+    struct Stats
+    {
+        uint64_t lookups = 0;
+        uint64_t hits = 0;
+        uint64_t inserts = 0;          // entradas nuevas o mejoradas por este proceso
+        double meanLookupUs = 0.0;     // canonizar + sondear + traducir la solucion
+        uint64_t entries = 0;
+        uint64_t slots = 0;
+        uint64_t fileBytes = 0;
+    };
+
+    SolutionCache() : m_data(nullptr), m_size(0), m_writer(false) {}
+    ~SolutionCache() { close(); }
+    SolutionCache(const SolutionCache&) = delete;
+    SolutionCache& operator=(const SolutionCache&) = delete;
+
+    // Abre o crea el fichero. Si otro proceso ya escribe en el, o no se puede escribir, se
+    // mapea solo para leer (y falla si aun no existe o no es valido). slots se redondea a
+    // potencia de 2.
+    bool open(const std::string& path, uint64_t slots = DEFAULT_SLOTS)
+    {
+        close();
+        uint64_t n = 1;
+        while (n < slots) n <<= 1;
+        if (!mapFile(path, sizeof(SolutionCacheHeader) + n * sizeof(SolutionCacheSlot))) return false;
+        m_path = path;
+        cornerPermConj();   // para que la primera consulta no pague la tabla
+        return true;
+    }
+
+    bool isOpen() const { return m_data != nullptr; }
+    bool canWrite() const { return m_writer; }
+    const std::string& path() const { return m_path; }
+
+    // Solucion guardada para `cube` (o una variante simetrica); con needOptimal solo si se
+    // guardo como optima
+    bool find(const CubieCube& cube, bool needOptimal, std::vector<int>& moves, bool* optimal = nullptr)
+    {
+        if (!m_data) return false;
+        auto t0 = std::chrono::steady_clock::now();
+        const CanonicalState canonical = canonicalize(cube);
+        Copy copy;
+        const bool hit = lookup(canonical, copy) && (!needOptimal || (copy.info & OPTIMAL));
+        if (hit) {
+            moves = solutionFromCanonical(unpackMoves(copy), canonical);
+            if (optimal) *optimal = (copy.info & OPTIMAL) != 0;
+        }
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0);
+        m_lookups.fetch_add(1, std::memory_order_relaxed);
+        m_lookupNs.fetch_add((uint64_t)ns.count(), std::memory_order_relaxed);
+        if (hit) m_hits.fetch_add(1, std::memory_order_relaxed);
+        return hit;
+    }
+
+    // Guarda la solucion si la entrada no existe o la nueva es mejor (optima frente a no
+    // optima, o mas corta). Sin efecto si el fichero es de solo lectura.
+    void store(const CubieCube& cube, const std::vector<int>& moves, bool optimal)
+    {
+        if (!m_data || !m_writer || moves.size() > (size_t)MAX_MOVES) return;
+        const CanonicalState canonical = canonicalize(cube);
+        const std::vector<int> canonicalMoves = solutionToCanonical(moves, canonical);
+        const uint64_t key = packKey(canonical);
+        const uint32_t info = USED | (optimal ? OPTIMAL : 0) | (uint32_t)canonical.flip << 8 | (uint32_t)moves.size();
+
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        const uint64_t mask = header().slotCount - 1;
+        const uint64_t home = canonical.hash() & mask;
+        int target = -1, victim = -1;
+        bool fresh = false;
+        for (int p = 0; p < PROBES; ++p) {
+            const SolutionCacheSlot& slot = slots()[(home + p) & mask];
+            const uint32_t old = slot.info.load(std::memory_order_relaxed);   // solo escribe este hilo
+            if (!(old & USED)) {
+                target = p;
+                fresh = true;
+                break;
+            }
+            if (slot.key.load(std::memory_order_relaxed) == key && ((old >> 8) & 0x7FF) == canonical.flip) {
+                const bool better = (optimal && !(old & OPTIMAL)) ||
+                                    (optimal == ((old & OPTIMAL) != 0) && moves.size() < (old & 0xFF));
+                if (!better) return;
+                target = p;
+                break;
+            }
+            // Si no hay sitio se sustituye la primera no optima (o la del hueco inicial)
+            if (victim < 0 && !(old & OPTIMAL)) victim = p;
+        }
+        if (target < 0) target = victim < 0 ? 0 : victim;
+
+        SolutionCacheSlot& slot = slots()[(home + target) & mask];
+        uint64_t words[6] = {};
+        for (size_t i = 0; i < canonicalMoves.size(); ++i)
+            words[i / 8] |= (uint64_t)canonicalMoves[i] << (i % 8 * 8);
+
+        const uint32_t seq = slot.seq.load(std::memory_order_relaxed) | 1;
+        slot.seq.store(seq, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.info.store(info, std::memory_order_relaxed);
+        slot.key.store(key, std::memory_order_relaxed);
+        for (int w = 0; w < 6; ++w) slot.moves[w].store(words[w], std::memory_order_relaxed);
+        slot.seq.store(seq + 1, std::memory_order_release);
+
+        if (fresh) header().entries.fetch_add(1, std::memory_order_relaxed);
+        m_inserts.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Stats stats() const
+    {
+        Stats s;
+        s.lookups = m_lookups.load();
+        s.hits = m_hits.load();
+        s.inserts = m_inserts.load();
+        s.meanLookupUs = s.lookups ? m_lookupNs.load() / 1000.0 / s.lookups : 0.0;
+        if (m_data) {
+            s.entries = header().entries.load(std::memory_order_relaxed);
+            s.slots = header().slotCount;
+            s.fileBytes = m_size;
+        }
+        return s;
+    }
+
+    void close()
+    {
+        unmapFile();
+        m_data = nullptr;
+        m_size = 0;
+        m_writer = false;
+        m_path.clear();
+    }
+
+private:
+    static const uint32_t USED = 1u << 31;
+    static const uint32_t OPTIMAL = 1u << 30;
+
+    unsigned char* m_data;
+    size_t m_size;
+    bool m_writer;
+    std::string m_path;
+    std::mutex m_writeMutex;
+    std::atomic<uint64_t> m_lookups{ 0 }, m_hits{ 0 }, m_inserts{ 0 }, m_lookupNs{ 0 };
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+
+    struct Copy
+    {
+        uint32_t info;
+        uint64_t key;
+        uint64_t moves[6];
+    };
+
+    SolutionCacheHeader& header() const { return *reinterpret_cast<SolutionCacheHeader*>(m_data); }
+    SolutionCacheSlot* slots() const
+    {
+        return reinterpret_cast<SolutionCacheSlot*>(m_data + sizeof(SolutionCacheHeader));
+    }
+
+    static uint64_t packKey(const CanonicalState& c)
+    {
+        return ((uint64_t)c.cornerPerm * NUM_TWIST + c.twist) * 479001600ull + c.edgePerm;
+    }
+
+    static std::vector<int> unpackMoves(const Copy& copy)
+    {
+        std::vector<int> moves(copy.info & 0xFF);
+        for (size_t i = 0; i < moves.size(); ++i) moves[i] = (int)((copy.moves[i / 8] >> (i % 8 * 8)) & 0xFF);
+        return moves;
+    }
+
+    // Copia coherente del hueco; false si sigue a medio escribir tras varios intentos
+    // (un escritor que murio a mitad lo deja impar hasta que otro lo sobrescriba)
+    static bool readSlot(const SolutionCacheSlot& slot, Copy& out)
+    {
+        for (int attempt = 0; attempt < 64; ++attempt) {
+            const uint32_t before = slot.seq.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            out.info = slot.info.load(std::memory_order_relaxed);
+            out.key = slot.key.load(std::memory_order_relaxed);
+            for (int w = 0; w < 6; ++w) out.moves[w] = slot.moves[w].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) == before) return true;
+        }
+        return false;
+    }
+
+    bool lookup(const CanonicalState& canonical, Copy& out) const
+    {
+        const uint64_t key = packKey(canonical);
+        const uint64_t mask = header().slotCount - 1;
+        const uint64_t home = canonical.hash() & mask;
+        for (int p = 0; p < PROBES; ++p) {
+            if (!readSlot(slots()[(home + p) & mask], out)) continue;
+            if (!(out.info & USED)) return false;
+            if (out.key == key && ((out.info >> 8) & 0x7FF) == canonical.flip) return true;
+        }
+        return false;
+    }
+
+    // Comprueba una cabecera existente, o la escribe si el fichero es nuevo y somos el escritor
+    bool initHeader(uint64_t existingSize, size_t newSize)
+    {
+        SolutionCacheHeader& h = header();
+        if (existingSize == 0) {
+            if (!m_writer) return false;
+            std::memcpy(h.magic, SOLUTION_CACHE_MAGIC, sizeof(h.magic));
+            h.format = SOLUTION_CACHE_FORMAT;
+            h.endian = TABLE_FILE_ENDIAN;
+            h.slotCount = (newSize - sizeof(SolutionCacheHeader)) / sizeof(SolutionCacheSlot);
+            h.entries.store(0, std::memory_order_relaxed);
+            return true;
+        }
+        return std::memcmp(h.magic, SOLUTION_CACHE_MAGIC, sizeof(h.magic)) == 0 && h.format == SOLUTION_CACHE_FORMAT &&
+               h.endian == TABLE_FILE_ENDIAN && h.slotCount != 0 && (h.slotCount & (h.slotCount - 1)) == 0 &&
+               sizeof(SolutionCacheHeader) + h.slotCount * sizeof(SolutionCacheSlot) == existingSize;
+    }
+
+#ifdef _WIN32
+    bool mapFile(const std::string& path, size_t newSize)
+    {
+        m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                             nullptr, OPEN_ALWAYS, FILE_FLAG_RANDOM_ACCESS, nullptr);
+        // Cerrojo sobre un byte mas alla del final: marca al escritor sin bloquear el mapeo
+        OVERLAPPED lockAt = {};
+        lockAt.OffsetHigh = 0x40000000;
+        m_writer = m_file != INVALID_HANDLE_VALUE &&
+                   LockFileEx(m_file, LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0, 1, 0, &lockAt) != 0;
+        if (!m_writer) {
+            if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+            m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                 nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE) return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size)) return fail();
+        const uint64_t existing = (uint64_t)size.QuadPart;
+        if (existing == 0 && !m_writer) return fail();
+        const size_t mapSize = existing ? (size_t)existing : newSize;
+        const DWORD high = (DWORD)((uint64_t)mapSize >> 32), low = (DWORD)mapSize;
+        m_mapping = CreateFileMappingA(m_file, nullptr, m_writer ? PAGE_READWRITE : PAGE_READONLY, high, low, nullptr);
+        if (!m_mapping) return fail();
+        m_data = (unsigned char*)MapViewOfFile(m_mapping, m_writer ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, 0);
+        m_size = mapSize;
+        return (m_data && initHeader(existing, newSize)) || fail();
+    }
+
+    void unmapFile()
+    {
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+        m_mapping = nullptr;
+        m_file = INVALID_HANDLE_VALUE;
+    }
+#else
+    bool mapFile(const std::string& path, size_t newSize)
+    {
+        m_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        // El cerrojo dura lo que este abierto el descriptor
+        m_writer = m_fd >= 0 && flock(m_fd, LOCK_EX | LOCK_NB) == 0;
+        if (!m_writer) {
+            if (m_fd >= 0) ::close(m_fd);
+            m_fd = ::open(path.c_str(), O_RDONLY);
+            if (m_fd < 0) return false;
+        }
+        struct stat st;
+        if (fstat(m_fd, &st) != 0) return fail();
+        const uint64_t existing = (uint64_t)st.st_size;
+        if (existing == 0 && (!m_writer || ftruncate(m_fd, (off_t)newSize) != 0)) return fail();
+        const size_t mapSize = existing ? (size_t)existing : newSize;
+        void* p = mmap(nullptr, mapSize, m_writer ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, m_fd, 0);
+        if (p == MAP_FAILED) return fail();
+        madvise(p, mapSize, MADV_RANDOM);
+        m_data = (unsigned char*)p;
+        m_size = mapSize;
+        return initHeader(existing, newSize) || fail();
+    }
+
+    void unmapFile()
+    {
+        if (m_data) munmap(m_data, m_size);
+        if (m_fd >= 0) ::close(m_fd);   // suelta el cerrojo
+        m_fd = -1;
+    }
+#endif
+
+    bool fail()
+    {
+        close();
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,310 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "cubieCube.h"
+#include "coordCube.h"
+
+//-----------------------------------simetrias------------------------------------------
+// Las 48 simetrias del cubo (24 rotaciones y sus reflejos) como CubieCube, numeradas
+// 16*urf3 + 8*f2 + 2*u4 + lr2 a partir de cuatro basicas (convenio de Kociemba):
+//   ROT_URF3   120 grados alrededor de la diagonal URF-DBL
+//   ROT_F2     180 grados alrededor del eje F-B
+//   ROT_U4     90 grados alrededor del eje U-D
+//   MIRR_LR2   reflejo en el plano que separa L de R (esquinas con orientacion 3)
+// Conjugar: conj(c, s) = S^-1 * c * S. Un estado, sus 48 conjugados y los de su inverso
+// estan a la misma distancia del resuelto, y las soluciones se traducen giro a giro.
+//
+// Las 16 primeras (urf3 = 0) dejan el eje U-D en su sitio: con ellas la orientacion de las
+// esquinas se conjuga sin mirar la permutacion, lo que permite reducir la base de patrones
+// de esquinas a una entrada por clase (CornerSymmetry).
+
+const int NUM_SYMS = 48;
+const int NUM_SYMS_UD = 16;
+
+constexpr CubieCube BASIC_SYMS[4] = {
+    // ROT_URF3
+    { { URF, DFR, DLF, UFL, UBR, DRB, DBL, ULB }, { 1, 2, 1, 2, 2, 1, 2, 1 },
+      { UF, FR, DF, FL, UB, BR, DB, BL, UR, DR, DL, UL }, { 1, 0, 1, 0, 1, 0, 1, 0, 1, 1, 1, 1 } },
+    // ROT_F2
+    { { DLF, DFR, DRB, DBL, UFL, URF, UBR, ULB }, { 0, 0, 0, 0, 0, 0, 0, 0 },
+      { DL, DF, DR, DB, UL, UF, UR, UB, FL, FR, BR, BL }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+    // ROT_U4
+    { { UBR, URF, UFL, ULB, DRB, DFR, DLF, DBL }, { 0, 0, 0, 0, 0, 0, 0, 0 },
+      { UB, UR, UF, UL, DB, DR, DF, DL, BR, FR, FL, BL }, { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1 } },
+    // MIRR_LR2
+    { { UFL, URF, UBR, ULB, DLF, DFR, DRB, DBL }, { 3, 3, 3, 3, 3, 3, 3, 3 },
+      { UL, UF, UR, UB, DL, DF, DR, DB, FL, FR, BR, BL }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+};
+
+constexpr std::array<CubieCube, NUM_SYMS> makeSymCubes()
+{
+    std::array<CubieCube, NUM_SYMS> syms{};
+    CubieCube c = CubieCube::identity();
+    int s = 0;
+    for (int urf3 = 0; urf3 < 3; ++urf3) {
+        for (int f2 = 0; f2 < 2; ++f2) {
+            for (int u4 = 0; u4 < 4; ++u4) {
+                for (int lr2 = 0; lr2 < 2; ++lr2) {
+                    syms[s++] = c;
+                    c.symMultiply(BASIC_SYMS[3]);
+                }
+                c.symMultiply(BASIC_SYMS[2]);
+            }
+            c.symMultiply(BASIC_SYMS[1]);
+        }
+        c.symMultiply(BASIC_SYMS[0]);
+    }
+    return syms;
+}
+
+inline constexpr std::array<CubieCube, NUM_SYMS> SYM_CUBES = makeSymCubes();
+
+constexpr std::array<uint8_t, NUM_SYMS> makeSymInverse()
+{
+    std::array<uint8_t, NUM_SYMS> inverse{};
+    for (int s = 0; s < NUM_SYMS; ++s)
+        for (int t = 0; t < NUM_SYMS; ++t) {
+            CubieCube c = SYM_CUBES[s];
+            c.symMultiply(SYM_CUBES[t]);
+            if (c == CubieCube::identity()) inverse[s] = (uint8_t)t;
+        }
+    return inverse;
+}
+
+inline constexpr std::array<uint8_t, NUM_SYMS> SYM_INVERSE = makeSymInverse();
+
+constexpr CubieCube conjugate(const CubieCube& c, int s)
+{
+    CubieCube r = SYM_CUBES[SYM_INVERSE[s]];
+    r.symMultiply(c);
+    r.symMultiply(SYM_CUBES[s]);
+    return r;
+}
+
+// SYM_MOVE[s][m] = giro que es conj(giro m, s): si c se resuelve con m1 m2 ..., conj(c, s)
+// se resuelve con SYM_MOVE[s][m1] SYM_MOVE[s][m2] ...
+constexpr std::array<std::array<uint8_t, NUM_MOVES>, NUM_SYMS> makeSymMoves()
+{
+    std::array<std::array<uint8_t, NUM_MOVES>, NUM_SYMS> table{};
+    for (int s = 0; s < NUM_SYMS; ++s)
+        for (int m = 0; m < NUM_MOVES; ++m) {
+            const CubieCube c = conjugate(MOVE_CUBES[m], s);
+            for (int k = 0; k < NUM_MOVES; ++k)
+                if (MOVE_CUBES[k] == c) table[s][m] = (uint8_t)k;
+        }
+    return table;
+}
+
+inline constexpr std::array<std::array<uint8_t, NUM_MOVES>, NUM_SYMS> SYM_MOVE = makeSymMoves();
+
+static_assert(SYM_INVERSE[0] == 0 && SYM_MOVE[1][0] == 2, "el reflejo L-R convierte U en U'");
+
+//---------------------------tablas de conjugacion--------------------------------------
+// Como las de giros: se generan la primera vez que se piden.
+
+// Permutacion de esquinas de conj(c, s): la parte cp de conjugate(), sin orientaciones ni aristas
+constexpr int conjugateCornerPerm(const CubieCube& c, int s)
+{
+    const CubieCube& sym = SYM_CUBES[s];
+    const CubieCube& inv = SYM_CUBES[SYM_INVERSE[s]];
+    uint8_t p[NUM_CORNERS] = {};
+    for (int i = 0; i < NUM_CORNERS; ++i) p[i] = inv.cp[c.cp[sym.cp[i]]];
+    return permRank(p, NUM_CORNERS);
+}
+
+// cornerPermConj()[cp * 48 + s] = permutacion de esquinas de conj(c, s) si c tiene cp
+inline const std::vector<uint16_t>& cornerPermConj()
+{
+    static const std::vector<uint16_t> table = [] {
+        std::vector<uint16_t> t((size_t)NUM_CORNER_PERM * NUM_SYMS);
+        for (int cp = 0; cp < NUM_CORNER_PERM; ++cp) {
+            CubieCube c = CubieCube::identity();
+            setCornerPerm(c, cp);
+            for (int s = 0; s < NUM_SYMS; ++s) t[(size_t)cp * NUM_SYMS + s] = (uint16_t)conjugateCornerPerm(c, s);
+        }
+        return t;
+    }();
+    return table;
+}
+
+//-------------------------esquinas reducidas por simetria------------------------------
+// Las 8! permutaciones de esquinas caen en 2768 clases bajo las 16 simetrias U-D. Un par
+// (cp, twist) se lleva al representante de su clase con una simetria s de esa clase y a
+// twist conjugado con la misma s: 2768 * 3^7 entradas en vez de 8! * 3^7 (14,6 veces menos).
+// Los estados que comparten entrada son conjugados entre si, asi que estan a la misma
+// distancia y la tabla sigue siendo exacta.
+// Si el representante es simetrico (lo fijan otras simetrias ademas de la identidad), esas
+// simetrias llevan un twist a otros equivalentes; se usa el menor, para que cada estado tenga
+// una sola entrada y la BFS no vea dos nodos distintos. Las demas entradas de esas clases
+// quedan sin usar.
+
+const int NUM_CORNER_CLASSES = 2768;
+
+struct CornerSymmetry
+{
+    std::vector<uint16_t> classSym;    // [cp] clase << 4 | simetria que la lleva al representante
+    std::vector<uint16_t> rep;         // [clase] permutacion representante (la menor)
+    std::vector<uint16_t> stabilizer;  // [clase] bit s = conj(rep, s) == rep
+    std::vector<uint16_t> twistConj;   // [twist * 16 + s] twist de conj(c, s), s < 16
+
+    uint32_t index(int cornerPerm, int twist) const
+    {
+        const int cs = classSym[cornerPerm], cls = cs >> 4;
+        int t = twistConj[twist * NUM_SYMS_UD + (cs & 15)];
+        const unsigned stab = stabilizer[cls];
+        if (stab != 1) {
+            const int base = t;
+            for (int s = 1; s < NUM_SYMS_UD; ++s)
+                if (stab >> s & 1) t = std::min<int>(t, twistConj[base * NUM_SYMS_UD + s]);
+        }
+        return (uint32_t)cls * NUM_TWIST + t;
+    }
+};
+
+inline const CornerSymmetry& cornerSymmetry()
+{
+    static const CornerSymmetry table = [] {
+        CornerSymmetry t;
+        t.classSym.assign(NUM_CORNER_PERM, 0xFFFF);
+        for (int cp = 0; cp < NUM_CORNER_PERM; ++cp) {
+            if (t.classSym[cp] != 0xFFFF) continue;
+            // La primera sin clase es la menor de la suya
+            const int cls = (int)t.rep.size();
+            t.rep.push_back((uint16_t)cp);
+            t.stabilizer.push_back(0);
+            CubieCube c = CubieCube::identity();
+            setCornerPerm(c, cp);
+            for (int s = 0; s < NUM_SYMS_UD; ++s) {
+                const int other = conjugateCornerPerm(c, s);
+                if (other == cp) t.stabilizer[cls] |= (uint16_t)(1 << s);
+                if (t.classSym[other] == 0xFFFF) t.classSym[other] = (uint16_t)(cls << 4 | SYM_INVERSE[s]);
+            }
+        }
+
+        t.twistConj.resize((size_t)NUM_TWIST * NUM_SYMS_UD);
+        for (int tw = 0; tw < NUM_TWIST; ++tw) {
+            CubieCube c = CubieCube::identity();
+            setTwist(c, tw);
+            for (int s = 0; s < NUM_SYMS_UD; ++s) t.twistConj[tw * NUM_SYMS_UD + s] = (uint16_t)getTwist(conjugate(c, s));
+        }
+
+        // La tabla de esquinas del solver optimo se dimensiona con NUM_CORNER_CLASSES
+        if (t.rep.size() != (size_t)NUM_CORNER_CLASSES) {
+            std::fprintf(stderr, "cornerSymmetry: %zu clases, se esperaban %d\n", t.rep.size(), NUM_CORNER_CLASSES);
+            std::abort();
+        }
+        return t;
+    }();
+    return table;
+}
+
+//--------------------------------estado canonico---------------------------------------
+// Representante de la clase de un estado bajo las 48 simetrias y la inversion (hasta 96
+// estados equivalentes): el menor por (cp, twist, permutacion de aristas, flip). Primero
+// se descarta con cornerPermConj todo lo que no tiene la menor cp; solo las simetrias que
+// empatan se conjugan enteras.
+
+struct CanonicalState
+{
+    uint16_t cornerPerm;
+    uint16_t twist;
+    uint32_t edgePerm;   // 0..12!-1
+    uint16_t flip;
+    uint8_t sym;         // canonico = conj(c, sym), o conj(c^-1, sym) si inverse
+    bool inverse;
+
+    bool sameClass(const CanonicalState& o) const
+    {
+        return cornerPerm == o.cornerPerm && twist == o.twist && edgePerm == o.edgePerm && flip == o.flip;
+    }
+
+    bool operator<(const CanonicalState& o) const
+    {
+        if (cornerPerm != o.cornerPerm) return cornerPerm < o.cornerPerm;
+        if (twist != o.twist) return twist < o.twist;
+        if (edgePerm != o.edgePerm) return edgePerm < o.edgePerm;
+        return flip < o.flip;
+    }
+
+    // Igual para todos los estados de la clase
+    uint64_t hash() const
+    {
+        const uint64_t corners = (uint64_t)cornerPerm * NUM_TWIST + twist;
+        return mix(mix(corners * 479001600ull + edgePerm) ^ flip);
+    }
+
+private:
+    static uint64_t mix(uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+};
+
+inline CanonicalState canonicalize(const CubieCube& cube)
+{
+    const std::vector<uint16_t>& conj = cornerPermConj();
+    const CubieCube bases[2] = { cube, cube.inverse() };
+
+    int best = NUM_CORNER_PERM;
+    for (int inv = 0; inv < 2; ++inv) {
+        const uint16_t* row = &conj[(size_t)getCornerPerm(bases[inv]) * NUM_SYMS];
+        for (int s = 0; s < NUM_SYMS; ++s) best = row[s] < best ? row[s] : best;
+    }
+
+    CanonicalState result{};
+    bool have = false;
+    for (int inv = 0; inv < 2; ++inv) {
+        const uint16_t* row = &conj[(size_t)getCornerPerm(bases[inv]) * NUM_SYMS];
+        for (int s = 0; s < NUM_SYMS; ++s) {
+            if (row[s] != best) continue;
+            const CubieCube c = conjugate(bases[inv], s);
+            const CanonicalState candidate{ (uint16_t)best, (uint16_t)getTwist(c),
+                                            (uint32_t)permRank(c.ep, NUM_EDGES), (uint16_t)getFlip(c),
+                                            (uint8_t)s, inv == 1 };
+            if (!have || candidate < result) result = candidate;
+            have = true;
+        }
+    }
+    return result;
+}
+
+inline uint64_t canonicalHash(const CubieCube& cube) { return canonicalize(cube).hash(); }
+
+// Solucion del estado original a partir de una del canonico (que es conj(c, sym) o la de c^-1)
+inline std::vector<int> solutionFromCanonical(const std::vector<int>& moves, const CanonicalState& canonical)
+{
+    const int back = SYM_INVERSE[canonical.sym];
+    std::vector<int> out;
+    out.reserve(moves.size());
+    for (int m : moves) out.push_back(SYM_MOVE[back][m]);
+    if (canonical.inverse) {
+        // c^-1 * M = 1  =>  c * M^-1 = 1: orden inverso y cada giro invertido
+        std::reverse(out.begin(), out.end());
+        for (int& m : out) m = m / 3 * 3 + 2 - m % 3;
+    }
+    return out;
+}
+
+// Al reves: solucion del canonico a partir de una del estado original
+inline std::vector<int> solutionToCanonical(const std::vector<int>& moves, const CanonicalState& canonical)
+{
+    std::vector<int> out(moves);
+    if (canonical.inverse) {
+        std::reverse(out.begin(), out.end());
+        for (int& m : out) m = m / 3 * 3 + 2 - m % 3;
+    }
+    for (int& m : out) m = SYM_MOVE[canonical.sym][m];
+    return out;
+}
+
+#endif
@@ -0,0 +1,419 @@
+#ifndef TABLEFILE_H
+#define TABLEFILE_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+//--------------------------------fichero de tablas-------------------------------------
+// Las tablas de poda se guardan en disco y se usan mapeadas en memoria (solo lectura):
+// sin copiar nada, varios procesos comparten las mismas paginas de la cache del sistema
+// y un arranque en frio solo lee las paginas que la busqueda llega a tocar.
+//
+// Formato:  cabecera | directorio de secciones | secciones (alineadas a 4096 bytes)
+// La cabecera y el directorio llevan checksum y se validan siempre al abrir; el checksum
+// de cada seccion solo se comprueba con verify(), porque obliga a leer el fichero entero.
+
+const char TABLE_FILE_MAGIC[8] = { 'C', 'U', 'B', 'I', 'T', 'B', 'L', '\0' };
+const uint32_t TABLE_FILE_FORMAT = 1;           // version del formato del fichero
+const uint32_t TABLE_FILE_ENDIAN = 0x01020304;  // detecta ficheros de otra arquitectura
+const uint64_t TABLE_FILE_ALIGN = 4096;
+const int TABLE_FILE_MAX_SECTIONS = 32;
+
+struct TableFileHeader
+{
+    char magic[8];
+    uint32_t format;
+    uint32_t contentVersion;     // version de las tablas (la sube quien cambie su definicion)
+    uint32_t endian;
+    uint32_t sectionCount;
+    uint64_t fileSize;
+    uint64_t directoryChecksum;  // cabecera (con este campo a 0) + directorio
+};
+
+struct TableSection
+{
+    char name[32];
+    uint64_t offset;
+    uint64_t size;
+    uint64_t checksum;
+};
+
+// FNV-1a sobre palabras de 64 bits (el resto, byte a byte)
+inline uint64_t tableChecksum(const void* data, size_t size, uint64_t h = 0xcbf29ce484222325ull)
+{
+    const uint64_t PRIME = 0x100000001b3ull;
+    const unsigned char* p = (const unsigned char*)data;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, p + i, 8);
+        h = (h ^ w) * PRIME;
+    }
+    for (; i < size; ++i) h = (h ^ p[i]) * PRIME;
+    return h;
+}
+
+inline uint64_t tableDirectoryChecksum(TableFileHeader header, const TableSection* sections)
+{
+    header.directoryChecksum = 0;
+    uint64_t h = tableChecksum(&header, sizeof(header));
+    return tableChecksum(sections, sizeof(TableSection) * header.sectionCount, h);
+}
+
+// Ruta de un fichero de tablas: directorio de $CUBI_TABLES o el directorio actual
+inline std::string tablePath(const char* fileName)
+{
+    const char* dir = std::getenv("CUBI_TABLES");
+    if (!dir || !*dir) return fileName;
+    std::string path = dir;
+    if (path.back() != '/' && path.back() != '\\') path += '/';
+    return path + fileName;
+}
+
+// De donde salieron las tablas de un solver
+enum class TableOrigin { Mapped, Generated, GeneratedNotSaved };
+
+inline const char* tableOriginName(TableOrigin origin)
+{
+    switch (origin) {
+    case TableOrigin::Mapped: return "mapeadas";
+    case TableOrigin::Generated: return "generadas y guardadas";
+    default: return "generadas (no se pudieron guardar)";
+    }
+}
+
+//--------------------------------lectura (mmap)----------------------------------------
+class MappedTableFile
+{
+public:
+    MappedTableFile() : m_data(nullptr), m_size(0) {}
+    ~MappedTableFile() { close(); }
+    MappedTableFile(const MappedTableFile&) = delete;
+    MappedTableFile& operator=(const MappedTableFile&) = delete;
+
+    // Falla (sin mensajes) si no existe, es de otra version o esta corrupto
+    bool open(const std::string& path, uint32_t contentVersion)
+    {
+        close();
+        if (!mapFile(path)) return false;
+
+        TableFileHeader header;
+        if (m_size < sizeof(header)) return fail();
+        std::memcpy(&header, m_data, sizeof(header));
+        if (std::memcmp(header.magic, TABLE_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+            header.format != TABLE_FILE_FORMAT || header.endian != TABLE_FILE_ENDIAN ||
+            header.contentVersion != contentVersion || header.fileSize != m_size ||
+            header.sectionCount > (uint32_t)TABLE_FILE_MAX_SECTIONS ||
+            m_size < sizeof(header) + sizeof(TableSection) * header.sectionCount)
+            return fail();
+
+        m_sections.resize(header.sectionCount);
+        std::memcpy(m_sections.data(), m_data + sizeof(header), sizeof(TableSection) * header.sectionCount);
+        if (tableDirectoryChecksum(header, m_sections.data()) != header.directoryChecksum) return fail();
+        for (const TableSection& s : m_sections)
+            if (s.offset > m_size || s.size > m_size - s.offset || s.name[sizeof(s.name) - 1] != '\0') return fail();
+        m_path = path;
+        return true;
+    }
+
+    // Puntero a la seccion dentro del mapeo; nullptr si no esta o no mide `size`
+    const void* section(const char* name, size_t size) const
+    {
+        for (const TableSection& s : m_sections)
+            if (std::strcmp(s.name, name) == 0) return s.size == size ? m_data + s.offset : nullptr;
+        return nullptr;
+    }
+
+    // Recalcula el checksum de todas las secciones (lee el fichero entero)
+    bool verify() const
+    {
+        for (const TableSection& s : m_sections)
+            if (tableChecksum(m_data + s.offset, s.size) != s.checksum) return false;
+        return isOpen();
+    }
+
+    bool isOpen() const { return m_data != nullptr; }
+    size_t size() const { return m_size; }
+    const std::string& path() const { return m_path; }
+
+    void close()
+    {
+        unmapFile();
+        m_data = nullptr;
+        m_size = 0;
+        m_sections.clear();
+        m_path.clear();
+    }
+
+private:
+    const unsigned char* m_data;
+    size_t m_size;
+    std::vector<TableSection> m_sections;
+    std::string m_path;
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#endif
+
+    bool fail()
+    {
+        close();
+        return false;
+    }
+
+#ifdef _WIN32
+    bool mapFile(const std::string& path)
+    {
+        m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                             OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) return fail();
+        m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mapping) return fail();
+        m_data = (const unsigned char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+        m_size = (size_t)size.QuadPart;
+        return m_data != nullptr || fail();
+    }
+
+    void unmapFile()
+    {
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+        m_mapping = nullptr;
+        m_file = INVALID_HANDLE_VALUE;
+    }
+#else
+    bool mapFile(const std::string& path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        // MAP_SHARED: las paginas son las de la cache del sistema, comunes a todos los procesos
+        void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        // Los accesos de IDA* son aleatorios: sin lectura anticipada
+        madvise(p, (size_t)st.st_size, MADV_RANDOM);
+        m_data = (const unsigned char*)p;
+        m_size = (size_t)st.st_size;
+        return true;
+    }
+
+    void unmapFile()
+    {
+        if (m_data) munmap((void*)m_data, m_size);
+    }
+#endif
+};
+
+//--------------------------------escritura---------------------------------------------
+// TableFileBuilder: se declaran las secciones, create() reserva el fichero y devuelve
+// punteros escribibles a cada una (mapeo de lectura/escritura), y commit() calcula los
+// checksums, escribe la cabecera y lo publica. Asi una tabla se genera directamente en
+// el formato del fichero, sin copia intermedia. Se escribe a un temporal y se renombra:
+// otro proceso nunca ve un fichero a medias.
+class TableFileBuilder
+{
+public:
+    TableFileBuilder() : m_data(nullptr), m_size(0) {}
+    ~TableFileBuilder() { discard(); }
+    TableFileBuilder(const TableFileBuilder&) = delete;
+    TableFileBuilder& operator=(const TableFileBuilder&) = delete;
+
+    void declare(const char* name, size_t size)
+    {
+        TableSection s;
+        std::memset(&s, 0, sizeof(s));
+        std::strncpy(s.name, name, sizeof(s.name) - 1);
+        s.size = size;
+        m_sections.push_back(s);
+    }
+
+    bool create(const std::string& path, uint32_t contentVersion)
+    {
+        discard();
+        if (m_sections.size() > (size_t)TABLE_FILE_MAX_SECTIONS) return false;
+
+        std::memset(&m_header, 0, sizeof(m_header));
+        std::memcpy(m_header.magic, TABLE_FILE_MAGIC, sizeof(m_header.magic));
+        m_header.format = TABLE_FILE_FORMAT;
+        m_header.contentVersion = contentVersion;
+        m_header.endian = TABLE_FILE_ENDIAN;
+        m_header.sectionCount = (uint32_t)m_sections.size();
+        uint64_t offset = alignUp(sizeof(m_header) + sizeof(TableSection) * m_sections.size());
+        for (TableSection& s : m_sections) {
+            s.offset = offset;
+            offset = alignUp(offset + s.size);
+        }
+        m_header.fileSize = offset;
+
+        m_path = path;
+#ifdef _WIN32
+        m_tmp = path + ".tmp" + std::to_string(_getpid());
+#else
+        m_tmp = path + ".tmp" + std::to_string(getpid());
+#endif
+        return mapFile();
+    }
+
+    void* section(const char* name) const
+    {
+        for (const TableSection& s : m_sections)
+            if (m_data && std::strcmp(s.name, name) == 0) return m_data + s.offset;
+        return nullptr;
+    }
+
+    bool commit()
+    {
+        if (!m_data) return false;
+        for (TableSection& s : m_sections) s.checksum = tableChecksum(m_data + s.offset, s.size);
+        m_header.directoryChecksum = tableDirectoryChecksum(m_header, m_sections.data());
+        std::memcpy(m_data, &m_header, sizeof(m_header));
+        std::memcpy(m_data + sizeof(m_header), m_sections.data(), sizeof(TableSection) * m_sections.size());
+
+        bool ok = unmapFile();
+#ifdef _WIN32
+        if (ok) std::remove(m_path.c_str());
+#endif
+        ok = ok && std::rename(m_tmp.c_str(), m_path.c_str()) == 0;
+        if (!ok) std::remove(m_tmp.c_str());
+        m_tmp.clear();
+        return ok;
+    }
+
+    // Abandona el fichero a medio generar
+    void discard()
+    {
+        if (m_data) unmapFile();
+        if (!m_tmp.empty()) std::remove(m_tmp.c_str());
+        m_tmp.clear();
+    }
+
+private:
+    TableFileHeader m_header;
+    std::vector<TableSection> m_sections;
+    unsigned char* m_data;
+    size_t m_size;
+    std::string m_path, m_tmp;
+
+    static uint64_t alignUp(uint64_t n) { return (n + TABLE_FILE_ALIGN - 1) / TABLE_FILE_ALIGN * TABLE_FILE_ALIGN; }
+
+#ifdef _WIN32
+    // Sin mmap de escritura: se genera en memoria y commit() lo vuelca
+    std::vector<unsigned char> m_image;
+
+    bool mapFile()
+    {
+        m_image.assign((size_t)m_header.fileSize, 0);
+        m_data = m_image.data();
+        m_size = m_image.size();
+        return true;
+    }
+
+    bool unmapFile()
+    {
+        FILE* f = std::fopen(m_tmp.c_str(), "wb");
+        bool ok = f && std::fwrite(m_image.data(), 1, m_image.size(), f) == m_image.size();
+        if (f) ok = std::fclose(f) == 0 && ok;
+        m_image.clear();
+        m_image.shrink_to_fit();
+        m_data = nullptr;
+        m_size = 0;
+        return ok;
+    }
+#else
+    bool mapFile()
+    {
+        const int fd = ::open(m_tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        void* p = MAP_FAILED;
+        if (reserveBlocks(fd, (off_t)m_header.fileSize))
+            p = mmap(nullptr, (size_t)m_header.fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            std::remove(m_tmp.c_str());
+            m_tmp.clear();
+            return false;
+        }
+        m_data = (unsigned char*)p;
+        m_size = (size_t)m_header.fileSize;
+        return true;
+    }
+
+    // Bloques reservados de verdad, no un fichero disperso: con el disco lleno, escribir en
+    // el mapeo daria SIGBUS a mitad de la generacion. Si no caben, create() falla y la tabla
+    // se genera en memoria.
+    static bool reserveBlocks(int fd, off_t size)
+    {
+#ifdef __APPLE__
+        fstore_t store = { F_ALLOCATEALL, F_PEOFPOSMODE, 0, size, 0 };
+        return fcntl(fd, F_PREALLOCATE, &store) != -1 && ftruncate(fd, size) == 0;
+#else
+        return posix_fallocate(fd, 0, size) == 0;
+#endif
+    }
+
+    bool unmapFile()
+    {
+        // msync: que un error de E/S al volcar las paginas se vea aqui y no al leer
+        const bool ok = msync(m_data, m_size, MS_SYNC) == 0;
+        munmap(m_data, m_size);
+        m_data = nullptr;
+        m_size = 0;
+        return ok;
+    }
+#endif
+};
+
+// Escribe secciones que ya estan en memoria (se apuntan sin copiar hasta write())
+class TableFileWriter
+{
+public:
+    void add(const char* name, const void* data, size_t size) { m_entries.push_back({ name, data, size }); }
+
+    bool write(const std::string& path, uint32_t contentVersion) const
+    {
+        TableFileBuilder builder;
+        for (const Entry& e : m_entries) builder.declare(e.name.c_str(), e.size);
+        if (!builder.create(path, contentVersion)) return false;
+        for (const Entry& e : m_entries) std::memcpy(builder.section(e.name.c_str()), e.data, e.size);
+        return builder.commit();
+    }
+
+private:
+    struct Entry
+    {
+        std::string name;
+        const void* data;
+        size_t size;
+    };
+    std::vector<Entry> m_entries;
+};
+
+#endif
@@ -0,0 +1,378 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Hilos de trabajo por defecto: $CUBI_THREADS o todos los nucleos
+inline int defaultThreadCount()
+{
+    const char* env = std::getenv("CUBI_THREADS");
+    const int n = env ? std::atoi(env) : 0;
+    return n > 0 ? n : (int)std::max(1u, std::thread::hardware_concurrency());
+}
+
+//------------------------------planificador de tareas----------------------------------
+// Un solo conjunto de hilos para todo el programa (TaskScheduler::instance()): la
+// generacion de tablas, el solver optimo, el modo por lotes y las soluciones pedidas desde
+// el visor reparten aqui su trabajo en vez de crear hilos propios.
+//
+// Cada hilo tiene una cola doble por prioridad: saca de la suya por delante y, cuando se
+// vacia, roba por detras de la de otro. Antes de coger una tarea Background se agotan las
+// Interactive de todas las colas, asi que lo que pide el visor adelanta a los lotes en
+// cuanto un hilo acaba la tarea que tiene entre manos (ninguna se corta a medias: por eso
+// las de fondo son pequenas, un bloque de tabla o una mezcla).
+//
+// Esperar (parallelFor, TaskGroup::wait) desde un hilo del planificador ejecuta otras tareas
+// mientras tanto, para que anidar trabajo no lo bloquee; desde fuera, el hilo duerme.
+
+enum class TaskPriority { Interactive, Background };
+const int NUM_TASK_PRIORITIES = 2;
+
+class TaskScheduler;
+
+// Tareas sueltas que se esperan juntas
+class TaskGroup
+{
+public:
+    explicit TaskGroup(TaskScheduler& scheduler) : m_scheduler(scheduler), m_pending(0) {}
+    ~TaskGroup() { wait(); }
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    inline void run(TaskPriority priority, std::function<void()> task);
+    inline void wait();
+
+private:
+    friend class TaskScheduler;
+    TaskScheduler& m_scheduler;
+    std::atomic<size_t> m_pending;
+    std::mutex m_mutex;
+    std::condition_variable m_done;
+
+    // Todo bajo el cerrojo: quien espera no puede destruir el grupo mientras se avisa
+    void finish()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) m_done.notify_all();
+    }
+};
+
+class TaskScheduler
+{
+public:
+    using IndexTask = std::function<void(size_t index, int worker)>;
+
+    struct Counters
+    {
+        int threads = 0;
+        uint64_t executed = 0;                      // tareas terminadas
+        uint64_t steals = 0;                        // de ellas, sacadas de la cola de otro hilo
+        double idleMs = 0.0;                        // tiempo dormido, sumado entre hilos
+        size_t queued[NUM_TASK_PRIORITIES] = {};    // esperando ahora mismo
+        size_t maxQueued = 0;                       // maximo esperando a la vez
+    };
+
+    // pinCores > 0: el hilo w se fija al nucleo w % pinCores
+    explicit TaskScheduler(int threads = defaultThreadCount(), int pinCores = 0)
+        : m_workers(std::max(1, threads)), m_queued(0), m_maxQueued(0), m_nextQueue(0), m_stop(false)
+    {
+        for (size_t p = 0; p < NUM_TASK_PRIORITIES; ++p) m_depth[p].store(0);
+        for (int w = 0; w < size(); ++w)
+            m_workers[w].thread = std::thread([this, w, pinCores] {
+                if (pinCores > 0) pinCurrentThread(w % pinCores);
+                workerLoop(w);
+            });
+    }
+
+    ~TaskScheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (Worker& w : m_workers) w.thread.join();
+    }
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // Tamano del planificador comun: antes del primer instance() (0 = por defecto).
+    // Sin llamarla: $CUBI_THREADS hilos, fijados a $CUBI_PIN nucleos si esta definida.
+    static void configure(int threads, int pinCores)
+    {
+        config().threads = threads;
+        config().pinCores = pinCores;
+    }
+
+    static TaskScheduler& instance()
+    {
+        static TaskScheduler scheduler(config().threads > 0 ? config().threads : defaultThreadCount(),
+                                       config().pinCores >= 0 ? config().pinCores : envPinCores());
+        return scheduler;
+    }
+
+    int size() const { return (int)m_workers.size(); }
+
+    // Hilo del planificador que ejecuta la llamada (-1 si no es de este planificador)
+    int currentWorker() const { return context().scheduler == this ? context().worker : -1; }
+
+    // task(i, hilo) para i = 0..count-1; vuelve cuando han terminado todas. Cada hilo
+    // recibe un bloque contiguo de indices y los hace en orden creciente.
+    void parallelFor(size_t count, TaskPriority priority, const IndexTask& task)
+    {
+        if (count == 0) return;
+        TaskGroup group(*this);
+        Job job{ &task, nullptr, &group };
+        group.m_pending.store(count);
+        const size_t n = m_workers.size();
+        for (size_t w = 0; w < n; ++w) {
+            const size_t begin = count * w / n, end = count * (w + 1) / n;
+            if (begin == end) continue;
+            Worker& q = m_workers[w];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            for (size_t i = begin; i < end; ++i) q.items[(int)priority].push_back({ &job, i });
+            queued(priority, end - begin);
+        }
+        wake(count);
+        group.wait();
+    }
+
+    Counters counters() const
+    {
+        Counters c;
+        c.threads = size();
+        for (const Worker& w : m_workers) {
+            c.executed += w.executed.load(std::memory_order_relaxed);
+            c.steals += w.steals.load(std::memory_order_relaxed);
+            c.idleMs += w.idleNs.load(std::memory_order_relaxed) / 1e6;
+        }
+        for (int p = 0; p < NUM_TASK_PRIORITIES; ++p) c.queued[p] = m_depth[p].load(std::memory_order_relaxed);
+        c.maxQueued = m_maxQueued.load(std::memory_order_relaxed);
+        return c;
+    }
+
+private:
+    friend class TaskGroup;
+
+    // Una tarea de parallelFor (index) o una suelta de TaskGroup::run (single, se borra al acabar)
+    struct Job
+    {
+        const IndexTask* task;
+        std::function<void()>* single;
+        TaskGroup* group;
+    };
+
+    struct Item
+    {
+        Job* job;
+        size_t index;
+    };
+
+    struct Worker
+    {
+        std::thread thread;
+        std::mutex mutex;
+        std::deque<Item> items[NUM_TASK_PRIORITIES];
+        std::atomic<uint64_t> executed{ 0 }, steals{ 0 }, idleNs{ 0 };
+    };
+
+    struct Config
+    {
+        int threads = 0;
+        int pinCores = -1;
+    };
+
+    struct Context
+    {
+        const TaskScheduler* scheduler = nullptr;
+        int worker = -1;
+    };
+
+    std::vector<Worker> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::atomic<size_t> m_queued;                       // total en todas las colas
+    std::atomic<size_t> m_depth[NUM_TASK_PRIORITIES];
+    std::atomic<size_t> m_maxQueued;
+    std::atomic<size_t> m_nextQueue;                    // reparto de las tareas sueltas de fuera
+    bool m_stop;
+
+    static Config& config()
+    {
+        static Config c;
+        return c;
+    }
+
+    static Context& context()
+    {
+        thread_local Context c;
+        return c;
+    }
+
+    static int envPinCores()
+    {
+        const char* env = std::getenv("CUBI_PIN");
+        return env ? std::max(0, std::atoi(env)) : 0;
+    }
+
+    static void pinCurrentThread(int core)
+    {
+#ifdef _WIN32
+        SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << (core % (int)(sizeof(DWORD_PTR) * 8)));
+#elif defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core % CPU_SETSIZE, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)core;   // sin afinidad de hilos: se deja al sistema
+#endif
+    }
+
+    void submit(TaskPriority priority, Job* job)
+    {
+        // Desde un hilo del planificador, a su propia cola; desde fuera, por turnos
+        const int own = currentWorker();
+        const size_t w = own >= 0 ? (size_t)own : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+        {
+            std::lock_guard<std::mutex> lock(m_workers[w].mutex);
+            m_workers[w].items[(int)priority].push_back({ job, 0 });
+            queued(priority, 1);
+        }
+        wake(1);
+    }
+
+    // Con el cerrojo de la cola donde se acaba de meter: pop() descuenta bajo ese mismo
+    // cerrojo, asi que no puede restar antes de que se haya sumado
+    void queued(TaskPriority priority, size_t count)
+    {
+        m_depth[(int)priority].fetch_add(count, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const size_t total = m_queued.fetch_add(count, std::memory_order_relaxed) + count;
+        if (total > m_maxQueued.load(std::memory_order_relaxed)) m_maxQueued.store(total, std::memory_order_relaxed);
+    }
+
+    void wake(size_t count)
+    {
+        if (count == 1) m_wake.notify_one();
+        else m_wake.notify_all();
+    }
+
+    // Siguiente tarea para el hilo w: prioridad antes que cercania
+    bool pop(int w, Item& item, bool& stolen)
+    {
+        const int n = size();
+        for (int p = 0; p < NUM_TASK_PRIORITIES; ++p) {
+            for (int k = 0; k < n; ++k) {
+                Worker& q = m_workers[(w + k) % n];
+                std::lock_guard<std::mutex> lock(q.mutex);
+                std::deque<Item>& items = q.items[p];
+                if (items.empty()) continue;
+                if (k == 0) {
+                    item = items.front();
+                    items.pop_front();
+                } else {
+                    item = items.back();
+                    items.pop_back();
+                }
+                stolen = k != 0;
+                m_depth[p].fetch_sub(1, std::memory_order_relaxed);
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool runOne(int w)
+    {
+        Item item;
+        bool stolen = false;
+        if (!pop(w, item, stolen)) return false;
+        Job* job = item.job;
+        TaskGroup* group = job->group;
+        if (job->single) {
+            (*job->single)();
+            delete job->single;
+            delete job;
+        } else {
+            (*job->task)(item.index, w);
+        }
+        Worker& self = m_workers[w];
+        self.executed.fetch_add(1, std::memory_order_relaxed);
+        if (stolen) self.steals.fetch_add(1, std::memory_order_relaxed);
+        group->finish();
+        return true;
+    }
+
+    void workerLoop(int w)
+    {
+        context().scheduler = this;
+        context().worker = w;
+        for (;;) {
+            if (runOne(w)) continue;
+            auto t0 = std::chrono::steady_clock::now();
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this] { return m_stop || m_queued.load(std::memory_order_relaxed) > 0; });
+                if (m_stop) return;
+            }
+            const auto idle = std::chrono::steady_clock::now() - t0;
+            m_workers[w].idleNs.fetch_add((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(idle).count(),
+                                          std::memory_order_relaxed);
+        }
+    }
+};
+
+inline void TaskGroup::run(TaskPriority priority, std::function<void()> task)
+{
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    TaskScheduler::Job* job = new TaskScheduler::Job{ nullptr, new std::function<void()>(std::move(task)), this };
+    m_scheduler.submit(priority, job);
+}
+
+inline void TaskGroup::wait()
+{
+    const int worker = m_scheduler.currentWorker();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_pending.load(std::memory_order_acquire) != 0) {
+        if (worker < 0) {
+            m_done.wait(lock, [this] { return m_pending.load(std::memory_order_acquire) == 0; });
+            break;
+        }
+        // Hilo del planificador: ayuda con lo que haya; si no hay nada, espera un poco
+        lock.unlock();
+        const bool ran = m_scheduler.runOne(worker);
+        lock.lock();
+        if (!ran)
+            m_done.wait_for(lock, std::chrono::microseconds(200),
+                            [this] { return m_pending.load(std::memory_order_acquire) == 0; });
+    }
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+//------------------------------triple buffer sin cerrojos------------------------------
+// Un escritor y un lector intercambian valores completos sin esperarse nunca:
+// el escritor rellena back() y publica; el lector, con update(), se queda con lo ultimo
+// publicado y lo lee en front() todo el tiempo que quiera. Lo que se publica sin que el
+// lector llegue a cogerlo se pierde (el lector solo quiere el mas reciente).
+//
+// Los tres huecos rotan entre back (escritor), middle (ultimo publicado) y front (lector);
+// solo middle es compartido: un byte atomico con el indice y un bit de "nuevo".
+
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() : m_middle(1), m_back(0), m_front(2) {}
+
+    // Los tres huecos con el mismo valor (front() es valido antes de la primera publicacion)
+    explicit TripleBuffer(const T& initial) : TripleBuffer()
+    {
+        for (T& slot : m_slots) slot = initial;
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // --- escritor ---
+    T& back() { return m_slots[m_back]; }
+
+    void publish()
+    {
+        m_back = m_middle.exchange((uint8_t)(m_back | FRESH), std::memory_order_acq_rel) & INDEX;
+    }
+
+    // --- lector ---
+    // Toma lo ultimo publicado; false si no hay nada nuevo desde la ultima vez
+    bool update()
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    const T& front() const { return m_slots[m_front]; }
+
+private:
+    static const uint8_t INDEX = 3;
+    static const uint8_t FRESH = 4;
+
+    T m_slots[3];
+    alignas(64) std::atomic<uint8_t> m_middle;
+    alignas(64) uint8_t m_back;     // solo el escritor
+    alignas(64) uint8_t m_front;    // solo el lector
+};
+
+#endif
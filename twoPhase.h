@@ -0,0 +1,287 @@
+#ifndef TWOPHASE_H
+#define TWOPHASE_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <cstdint>
+
+#include "coordCube.h"
+#include "pruning.h"
+
+//----------------------------solver en dos fases (Kociemba)----------------------------
+// Fase 1: llevar el cubo al subgrupo G1 = <U, D, R2, L2, F2, B2> (twist = flip = slice = 0)
+//         con los 18 giros.
+// Fase 2: resolver dentro de G1 con sus 10 giros (permutacion de esquinas, de las 8
+//         aristas U/D y de las 4 del slice).
+// Ambas fases son IDA* con el maximo de dos tablas de poda como heuristica. Tras la
+// primera solucion se sigue buscando otra mas corta hasta `targetLength` o el tiempo limite.
+
+const char TWO_PHASE_TABLE_FILE[] = "cubi_twophase.tbl";
+const uint32_t TWO_PHASE_TABLE_VERSION = 2;   // subir si cambian las tablas de poda o de giros
+
+const int NUM_UD_EDGE_PERM = 40320;   // 8! (aristas U/D, solo valida dentro de G1)
+const int NUM_SLICE_PERM = 24;        // 4! (= sliceSorted dentro de G1)
+
+// U U2 U' R2 F2 D D2 D' L2 B2
+const std::vector<int> PHASE2_MOVES = { 0, 1, 2, 4, 7, 9, 10, 11, 13, 16 };
+
+constexpr bool isPhase2Move(int m) { return m / 3 == 0 || m / 3 == 3 || m % 3 == 1; }
+
+// Tablas compartidas por todas las busquedas. Las de poda y las de giros propias de este
+// solver se mapean de TWO_PHASE_TABLE_FILE (las de giros de coordenadas, de
+// COORD_MOVE_TABLE_FILE); si no existe (o es de otra version) se generan una vez y se
+// guardan para la siguiente.
+struct TwoPhaseTables
+{
+    PruningTable twistSlice;     // fase 1: (twist, slice)
+    PruningTable flipSlice;      // fase 1: (flip, slice)
+    PruningTable cornerSlice;    // fase 2: (cornerPerm, slicePerm)
+    PruningTable edgeSlice;      // fase 2: (udEdgePerm, slicePerm)
+
+    TableOrigin origin;
+    std::string path;
+
+    static const TwoPhaseTables& get()
+    {
+        static const TwoPhaseTables tables;
+        return tables;
+    }
+
+    // slice = sliceSorted / 24
+    const MoveTable<NUM_SLICE>& sliceMove() const { return *m_sliceMove; }
+    // Solo columnas de PHASE2_MOVES
+    const MoveTable<NUM_UD_EDGE_PERM>& udEdgePermMove() const { return *m_udEdgePermMove; }
+
+    // Comprueba el checksum de cada seccion del fichero mapeado (lo lee entero)
+    bool verify() const { return !m_file.isOpen() || m_file.verify(); }
+
+private:
+    TwoPhaseTables()
+    {
+        path = tablePath(TWO_PHASE_TABLE_FILE);
+        if (m_file.open(path, TWO_PHASE_TABLE_VERSION) &&
+            attachMoveTable(m_file, "sliceMove", m_sliceMove) &&
+            attachMoveTable(m_file, "udEdgePermMove", m_udEdgePermMove) &&
+            twistSlice.attach(m_file, "twistSlice", NUM_TWIST, NUM_SLICE) &&
+            flipSlice.attach(m_file, "flipSlice", NUM_FLIP, NUM_SLICE) &&
+            cornerSlice.attach(m_file, "cornerSlice", NUM_CORNER_PERM, NUM_SLICE_PERM) &&
+            edgeSlice.attach(m_file, "edgeSlice", NUM_UD_EDGE_PERM, NUM_SLICE_PERM)) {
+            origin = TableOrigin::Mapped;
+            return;
+        }
+        m_file.close();
+
+        const MoveTable<NUM_SLICE_SORTED>& sliceSorted = sliceSortedMove();
+        m_ownedSliceMove.reset(new MoveTable<NUM_SLICE>{});
+        for (int s = 0; s < NUM_SLICE; ++s)
+            for (int m = 0; m < NUM_MOVES; ++m)
+                m_ownedSliceMove->next[s][m] = (uint16_t)(sliceSorted[s * 24][m] / 24);
+
+        m_ownedUdEdgePermMove.reset(new MoveTable<NUM_UD_EDGE_PERM>{});
+        for (int i = 0; i < NUM_UD_EDGE_PERM; ++i) {
+            CubieCube c = CubieCube::identity();
+            permUnrank(c.ep, 8, i);
+            for (int m : PHASE2_MOVES) {
+                CubieCube n = c;
+                n.edgeMultiply(MOVE_CUBES[m]);
+                m_ownedUdEdgePermMove->next[i][m] = (uint16_t)permRank(n.ep, 8);
+            }
+        }
+        m_sliceMove = m_ownedSliceMove.get();
+        m_udEdgePermMove = m_ownedUdEdgePermMove.get();
+
+        std::vector<int> allMoves;
+        for (int m = 0; m < NUM_MOVES; ++m) allMoves.push_back(m);
+
+        // sliceSorted < 24 dentro de G1, asi que su tabla sirve para slicePerm
+        twistSlice.build(TWIST_MOVE, NUM_TWIST, *m_sliceMove, NUM_SLICE, allMoves, 0, 0);
+        flipSlice.build(FLIP_MOVE, NUM_FLIP, *m_sliceMove, NUM_SLICE, allMoves, 0, 0);
+        cornerSlice.build(cornerPermMove(), NUM_CORNER_PERM, sliceSorted, NUM_SLICE_PERM, PHASE2_MOVES, 0, 0);
+        edgeSlice.build(*m_udEdgePermMove, NUM_UD_EDGE_PERM, sliceSorted, NUM_SLICE_PERM, PHASE2_MOVES, 0, 0);
+
+        TableFileWriter writer;
+        writer.add("sliceMove", m_sliceMove, sizeof(*m_sliceMove));
+        writer.add("udEdgePermMove", m_udEdgePermMove, sizeof(*m_udEdgePermMove));
+        twistSlice.save(writer, "twistSlice");
+        flipSlice.save(writer, "flipSlice");
+        cornerSlice.save(writer, "cornerSlice");
+        edgeSlice.save(writer, "edgeSlice");
+        origin = writer.write(path, TWO_PHASE_TABLE_VERSION) ? TableOrigin::Generated : TableOrigin::GeneratedNotSaved;
+    }
+
+    MappedTableFile m_file;
+    const MoveTable<NUM_SLICE>* m_sliceMove = nullptr;
+    const MoveTable<NUM_UD_EDGE_PERM>* m_udEdgePermMove = nullptr;
+    std::unique_ptr<MoveTable<NUM_SLICE>> m_ownedSliceMove;              // solo si no se pudo mapear
+    std::unique_ptr<MoveTable<NUM_UD_EDGE_PERM>> m_ownedUdEdgePermMove;
+};
+
+class TwoPhaseSolver
+{
+public:
+    static constexpr int MAX_LENGTH = 30;
+    static constexpr int MAX_PHASE2 = 12;
+
+    struct Result
+    {
+        bool found = false;
+        std::vector<int> moves;   // indices 0..17 (ver moveToTurn)
+        double ms = 0.0;
+        long nodes = 0;
+    };
+
+    TwoPhaseSolver() : m_tables(TwoPhaseTables::get()) {}
+
+    // Devuelve la primera solucion de <= targetLength giros, o la mejor encontrada
+    // cuando se acaba el tiempo (si hay alguna; si no, sigue hasta encontrar una)
+    Result solve(const CubieCube& cube, int targetLength = 22, double timeoutMs = 25.0)
+    {
+        Result result;
+        auto t0 = std::chrono::steady_clock::now();
+        if (!cube.isValid()) return result;
+
+        m_start = CoordCube::fromCubie(cube);
+        m_result = &result;
+        m_best = MAX_LENGTH + 1;
+        m_target = targetLength;
+        m_timeoutMs = timeoutMs;
+        m_startTime = t0;
+        m_done = false;
+
+        const int slice = m_start.sliceSorted / 24;
+        const int h = phase1Bound(m_start.twist, m_start.flip, slice);
+        for (int depth = h; depth < m_best && !m_done; ++depth)
+            phase1(m_start.twist, m_start.flip, slice, 0, depth, -1);
+
+        result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        return result;
+    }
+
+private:
+    const TwoPhaseTables& m_tables;
+    CoordCube m_start;
+    Result* m_result;
+    int m_path[MAX_LENGTH];
+    int m_best;
+    int m_target;
+    double m_timeoutMs;
+    std::chrono::steady_clock::time_point m_startTime;
+    bool m_done;
+
+    int phase1Bound(int twist, int flip, int slice) const
+    {
+        int a = m_tables.twistSlice.depth(twist, slice);
+        int b = m_tables.flipSlice.depth(flip, slice);
+        return a > b ? a : b;
+    }
+
+    int phase2Bound(int corner, int edge, int slicePerm) const
+    {
+        int a = m_tables.cornerSlice.depth(corner, slicePerm);
+        int b = m_tables.edgeSlice.depth(edge, slicePerm);
+        return a > b ? a : b;
+    }
+
+    // Mismo giro de cara seguido, o caras opuestas en orden inverso: redundante
+    static bool skipAfter(int lastFace, int face)
+    {
+        return lastFace >= 0 && (face == lastFace || face + 3 == lastFace);
+    }
+
+    void phase1(int twist, int flip, int slice, int depth, int togo, int lastFace)
+    {
+        if ((++m_result->nodes & 4095) == 0 && timedOut()) m_done = true;
+        if (m_done) return;
+
+        if (togo == 0) {
+            // Si el ultimo giro ya es de G1, esta solucion se explora con una fase 1 mas corta
+            if (depth == 0 || !isPhase2Move(m_path[depth - 1])) startPhase2(depth);
+            return;
+        }
+
+        for (int m = 0; m < NUM_MOVES; ++m) {
+            if (skipAfter(lastFace, m / 3)) continue;
+            // Se poda en cuanto una de las dos tablas supera lo que queda (h > togo - 1)
+            const int s = m_tables.sliceMove()[slice][m];
+            const int t = TWIST_MOVE[twist][m];
+            if (m_tables.twistSlice.depth(t, s) >= togo) continue;
+            const int f = FLIP_MOVE[flip][m];
+            if (m_tables.flipSlice.depth(f, s) >= togo) continue;
+            m_path[depth] = m;
+            phase1(t, f, s, depth + 1, togo - 1, m / 3);
+            if (m_done) return;
+        }
+    }
+
+    void startPhase2(int depth1)
+    {
+        // Coordenadas de fase 2 reaplicando los giros de la fase 1
+        int corner = m_start.cornerPerm, sliceSorted = m_start.sliceSorted;
+        int uEdges = m_start.uEdges, dEdges = m_start.dEdges;
+        const MoveTable<NUM_CORNER_PERM>& cornerMove = cornerPermMove();
+        const MoveTable<NUM_SLICE_SORTED>& sliceMove = sliceSortedMove();
+        const MoveTable<NUM_SLICE_SORTED>& uMove = uEdgesMove();
+        const MoveTable<NUM_SLICE_SORTED>& dMove = dEdgesMove();
+        for (int i = 0; i < depth1; ++i) {
+            const int m = m_path[i];
+            corner = cornerMove[corner][m];
+            sliceSorted = sliceMove[sliceSorted][m];
+            uEdges = uMove[uEdges][m];
+            dEdges = dMove[dEdges][m];
+        }
+
+        // Fases 2 largas son caras: mejor probar otra solucion de fase 1 algo mas larga
+        const int maxDepth2 = std::min(m_best - 1 - depth1, MAX_PHASE2);
+        if (maxDepth2 < 0 || m_tables.cornerSlice.depth(corner, sliceSorted) > maxDepth2) return;
+
+        // Dentro de G1 las aristas U y D ocupan las posiciones 0..7
+        CubieCube c = CubieCube::identity();
+        uint8_t ep[8] = {};
+        setEdges4(c, UR, uEdges);
+        for (int i = 0; i < 8; ++i) if (c.ep[i] < 4) ep[i] = c.ep[i];
+        setEdges4(c, DR, dEdges);
+        for (int i = 0; i < 8; ++i) if (c.ep[i] >= 4 && c.ep[i] < 8) ep[i] = c.ep[i];
+        const int edge = permRank(ep, 8);
+
+        const int lastFace = depth1 > 0 ? m_path[depth1 - 1] / 3 : -1;
+        for (int depth2 = phase2Bound(corner, edge, sliceSorted); depth2 <= maxDepth2; ++depth2) {
+            if (phase2(corner, edge, sliceSorted, depth1, depth2, lastFace)) {
+                m_best = depth1 + depth2;
+                m_result->found = true;
+                m_result->moves.assign(m_path, m_path + m_best);
+                if (m_best <= m_target) m_done = true;
+                return;
+            }
+        }
+    }
+
+    bool phase2(int corner, int edge, int slicePerm, int depth, int togo, int lastFace)
+    {
+        m_result->nodes++;
+        if (togo == 0) return corner == 0 && edge == 0 && slicePerm == 0;
+
+        for (int m : PHASE2_MOVES) {
+            if (skipAfter(lastFace, m / 3)) continue;
+            const int s = sliceSortedMove()[slicePerm][m];
+            const int c = cornerPermMove()[corner][m];
+            if (m_tables.cornerSlice.depth(c, s) >= togo) continue;
+            const int e = m_tables.udEdgePermMove()[edge][m];
+            if (m_tables.edgeSlice.depth(e, s) >= togo) continue;
+            m_path[depth] = m;
+            if (phase2(c, e, s, depth + 1, togo - 1, m / 3)) return true;
+        }
+        return false;
+    }
+
+    bool timedOut() const
+    {
+        if (!m_result->found) return false;   // sin solucion todavia: seguir
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_startTime).count();
+        return ms > m_timeoutMs;
+    }
+};
+
+#endif